@@ -0,0 +1,48 @@
+#ifndef CBAG_GDSII_BYTE_SWAP_H
+#define CBAG_GDSII_BYTE_SWAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cbag {
+namespace gdsii {
+
+/** The instruction sets used by the array conversion kernels.
+ */
+enum class simd_level : uint8_t {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+};
+
+/** Returns the best instruction set supported by the running CPU.
+ */
+simd_level get_simd_level() noexcept;
+
+/** Converts big-endian bytes to an array of 4-byte integers.
+ *
+ *  All conversion functions use the kernel of the given level, or of the best level supported
+ *  by the CPU if that is lower.  The source and destination must not overlap.
+ */
+void decode_int32_array(const char *src, int32_t *dst, std::size_t num,
+                        simd_level level = get_simd_level());
+
+/** Converts an array of 4-byte integers to big-endian bytes.
+ */
+void encode_int32_array(const int32_t *src, char *dst, std::size_t num,
+                        simd_level level = get_simd_level());
+
+/** Converts big-endian bytes to an array of 8-byte integers, such as GDS reals.
+ */
+void decode_uint64_array(const char *src, uint64_t *dst, std::size_t num,
+                         simd_level level = get_simd_level());
+
+/** Converts an array of 8-byte integers, such as GDS reals, to big-endian bytes.
+ */
+void encode_uint64_array(const uint64_t *src, char *dst, std::size_t num,
+                         simd_level level = get_simd_level());
+
+} // namespace gdsii
+} // namespace cbag
+
+#endif
@@ -7,16 +7,21 @@
 #include <tuple>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include <boost/container_hash/hash.hpp>
 
+#include <fmt/core.h>
+
 #include <cbag/logging/logging.h>
 
 #include <cbag/util/io.h>
 
 #include <cbag/common/layer_t.h>
 #include <cbag/enum/boundary_type.h>
+#include <cbag/gdsii/record_cursor.h>
 #include <cbag/gdsii/record_type.h>
+#include <cbag/gdsii/struct_index.h>
 #include <cbag/gdsii/typedefs.h>
 #include <cbag/layout/cellview.h>
 #include <cbag/layout/routing_grid_fwd.h>
@@ -45,50 +50,98 @@ class gds_rlookup {
 
 std::tuple<record_type, std::size_t> read_record_header(std::istream &stream);
 
+std::string read_gds_start(spdlog::logger &logger, record_cursor &cursor);
+
 std::string read_gds_start(spdlog::logger &logger, std::istream &stream);
 
+std::tuple<std::string, std::unique_ptr<layout::cellview>>
+read_lay_cellview(spdlog::logger &logger, record_cursor &cursor, const std::string &lib_name,
+                  const layout::routing_grid &g, const gds_rlookup &rmap,
+                  const std::unordered_map<std::string, layout::cellview *> &master_map);
+
 std::tuple<std::string, std::unique_ptr<layout::cellview>>
 read_lay_cellview(spdlog::logger &logger, std::istream &stream, const std::string &lib_name,
                   const layout::routing_grid &g, const gds_rlookup &rmap,
                   const std::unordered_map<std::string, layout::cellview *> &master_map);
 
+/** Reads the given waves of structures, parsing the structures of each wave concurrently.
+ *
+ *  @param logger the logger.  Messages from worker threads are serialized onto its sinks.
+ *  @param cursor the cursor over the whole GDS file.
+ *  @param index the structure index of the file.
+ *  @param waves the structures to read, as returned by struct_index::get_waves().
+ *  @param g the routing grid.
+ *  @param rmap the GDS layer mapping.
+ *  @param num_workers the number of workers.  0 means use all hardware threads.
+ *  @return the cellviews, indexed by structure index.  Structures not in waves are null.
+ */
+std::vector<std::unique_ptr<layout::cellview>>
+read_lay_cellviews(spdlog::logger &logger, const record_cursor &cursor, const struct_index &index,
+                   const std::vector<std::vector<std::size_t>> &waves,
+                   const layout::routing_grid &g, const gds_rlookup &rmap,
+                   std::size_t num_workers = 0);
+
+/** Reads all structures of a GDS file, and writes the cellviews to out_iter in file order.
+ *
+ *  The file is first scanned for structure boundaries and instance dependencies, then
+ *  structures are parsed concurrently, with every master parsed before its parents.  Masters
+ *  may appear anywhere in the file.
+ */
 template <class OutIter>
 void read_gds(const std::string &fname, const std::string &layer_map, const std::string &obj_map,
-              const layout::routing_grid &g, OutIter &&out_iter) {
+              const layout::routing_grid &g, OutIter &&out_iter, std::size_t num_workers = 0) {
     auto log_ptr = get_cbag_logger();
 
-    // get gds file stream
+    // map the gds file and index its structures
     log_ptr->info("Reading GDS file {}", fname);
-    auto stream = util::open_file_read(fname, true);
-    auto lib_name = read_gds_start(*log_ptr, stream);
-    log_ptr->info("GDS library: {}", lib_name);
+    record_cursor cursor(fname);
+    struct_index index(*log_ptr, cursor);
+    log_ptr->info("GDS library: {}", index.get_lib_name());
+
+    gds_rlookup rmap(layer_map, obj_map, *(g.get_tech()));
+    auto cv_list =
+        read_lay_cellviews(*log_ptr, cursor, index, index.get_waves(), g, rmap, num_workers);
+    for (auto &cv_ptr : cv_list) {
+        *out_iter = std::move(cv_ptr);
+        ++out_iter;
+    }
+    log_ptr->info("Finish reading GDS file {}", fname);
+}
+
+/** Reads a cell of a GDS file and all cells in its hierarchy, skipping every other structure.
+ *
+ *  Only the structures reachable from top_cell are parsed, so time and memory scale with the
+ *  size of its hierarchy rather than the size of the library.  The cellviews are written to
+ *  out_iter in file order.
+ */
+template <class OutIter>
+void read_gds_cell(const std::string &fname, const std::string &top_cell,
+                   const std::string &layer_map, const std::string &obj_map,
+                   const layout::routing_grid &g, OutIter &&out_iter,
+                   std::size_t num_workers = 0) {
+    auto log_ptr = get_cbag_logger();
+
+    // map the gds file and index its structures
+    log_ptr->info("Reading cell {} from GDS file {}", top_cell, fname);
+    record_cursor cursor(fname);
+    struct_index index(*log_ptr, cursor);
+    auto top_idx = index.find(top_cell);
+    if (top_idx == struct_index::npos) {
+        auto msg = fmt::format("Cannot find layout cellview {} in GDS file.", top_cell);
+        log_ptr->error(msg);
+        throw std::runtime_error(msg);
+    }
+    auto idx_list = index.get_closure(top_idx);
+    log_ptr->info("Reading {} of {} GDS structures", idx_list.size(), index.size());
 
-    bool is_done = false;
     gds_rlookup rmap(layer_map, obj_map, *(g.get_tech()));
-    std::unordered_map<std::string, layout::cellview *> cv_map;
-    while (!is_done) {
-        auto [rtype, rsize] = read_record_header(stream);
-        switch (rtype) {
-        case record_type::BGNSTR: {
-            log_ptr->info("Reading GDS cellview");
-            stream.ignore(rsize);
-            auto [cell_name, cv_ptr] =
-                read_lay_cellview(*log_ptr, stream, lib_name, g, rmap, cv_map);
-
-            cv_map.emplace(cell_name, cv_ptr.get());
-            *out_iter = std::move(cv_ptr);
-            ++out_iter;
-            break;
-        }
-        case record_type::ENDLIB:
-            log_ptr->info("Finish reading GDS file {}", fname);
-            stream.close();
-            return;
-        default:
-            throw std::runtime_error("Unrecognized GDS record type: " +
-                                     std::to_string(static_cast<int>(rtype)));
-        }
+    auto cv_list = read_lay_cellviews(*log_ptr, cursor, index, index.get_waves(idx_list), g, rmap,
+                                      num_workers);
+    for (auto idx : idx_list) {
+        *out_iter = std::move(cv_list[idx]);
+        ++out_iter;
     }
+    log_ptr->info("Finish reading cell {} from GDS file {}", top_cell, fname);
 }
 
 } // namespace gdsii
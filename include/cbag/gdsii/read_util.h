@@ -9,6 +9,7 @@
 
 #include <cbag/common/layer_t.h>
 #include <cbag/common/transformation.h>
+#include <cbag/gdsii/record_cursor.h>
 #include <cbag/gdsii/record_type.h>
 #include <cbag/gdsii/typedefs.h>
 #include <cbag/layout/polygon.h>
@@ -38,32 +39,34 @@ template <typename T, util::IsInt<T> = 0> T read_bytes(std::istream &stream) {
 
 std::tuple<record_type, std::size_t> read_record_header(std::istream &stream);
 
-void read_header(spdlog::logger &logger, std::istream &stream);
+void read_header(spdlog::logger &logger, record_cursor &cursor);
 
-void read_lib_begin(spdlog::logger &logger, std::istream &stream);
+void read_lib_begin(spdlog::logger &logger, record_cursor &cursor);
 
-std::string read_lib_name(spdlog::logger &logger, std::istream &stream);
+std::string read_lib_name(spdlog::logger &logger, record_cursor &cursor);
 
-void read_units(spdlog::logger &logger, std::istream &stream);
+void read_units(spdlog::logger &logger, record_cursor &cursor);
 
-std::string read_struct_name(spdlog::logger &logger, std::istream &stream);
+std::string read_struct_name(spdlog::logger &logger, record_cursor &cursor);
+
+transformation read_transform(spdlog::logger &logger, record_cursor &cursor);
 
 transformation read_transform(spdlog::logger &logger, std::istream &stream);
 
 std::tuple<gds_layer_t, transformation, std::string, double> read_text(spdlog::logger &logger,
-                                                                       std::istream &stream);
+                                                                       record_cursor &cursor);
 
-std::tuple<gds_layer_t, layout::polygon> read_box(spdlog::logger &logger, std::istream &stream);
+std::tuple<gds_layer_t, layout::polygon> read_box(spdlog::logger &logger, record_cursor &cursor);
 
 std::tuple<gds_layer_t, layout::polygon> read_boundary(spdlog::logger &logger,
-                                                       std::istream &stream);
+                                                       record_cursor &cursor);
 
 layout::instance
-read_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt,
+read_instance(spdlog::logger &logger, record_cursor &cursor, std::size_t &cnt,
               const std::unordered_map<std::string, layout::cellview *> &master_map);
 
 layout::instance
-read_arr_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt,
+read_arr_instance(spdlog::logger &logger, record_cursor &cursor, std::size_t &cnt,
                   const std::unordered_map<std::string, layout::cellview *> &master_map);
 
 bool print_record(std::istream &stream);
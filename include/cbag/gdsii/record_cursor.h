@@ -0,0 +1,184 @@
+#ifndef CBAG_GDSII_RECORD_CURSOR_H
+#define CBAG_GDSII_RECORD_CURSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cbag/common/point.h>
+#include <cbag/gdsii/byte_swap.h>
+#include <cbag/gdsii/record_type.h>
+
+namespace cbag {
+namespace gdsii {
+
+/** Decodes a big-endian unsigned integer from the given bytes.
+ */
+template <typename T> T decode_bytes(const char *data) noexcept {
+    auto ptr = reinterpret_cast<const unsigned char *>(data);
+    auto ans = static_cast<T>(0);
+    for (std::size_t bidx = 0; bidx < sizeof(T); ++bidx) {
+        ans = static_cast<T>((ans << 8) | static_cast<T>(ptr[bidx]));
+    }
+    return ans;
+}
+
+inline int32_t decode_int32(const char *data) noexcept {
+    return static_cast<int32_t>(decode_bytes<uint32_t>(data));
+}
+
+/** A view of the points of a GDS XY record.
+ *
+ *  Points are decoded on access, so no copies are made until the caller asks for them.
+ */
+class xy_span {
+  private:
+    const char *ptr = nullptr;
+    std::size_t num = 0;
+
+  public:
+    xy_span() = default;
+
+    xy_span(const char *ptr, std::size_t num) : ptr(ptr), num(num) {}
+
+    std::size_t size() const noexcept { return num; }
+
+    bool empty() const noexcept { return num == 0; }
+
+    point operator[](std::size_t idx) const noexcept {
+        auto cur = ptr + 8 * idx;
+        return {decode_int32(cur), decode_int32(cur + 4)};
+    }
+
+    void get_points(std::vector<point> &out) const {
+        static_assert(sizeof(point) == 2 * sizeof(int32_t), "point must be two packed int32");
+        auto old_size = out.size();
+        out.resize(old_size + num);
+        if (num > 0)
+            decode_int32_array(ptr, out[old_size].data(), 2 * num);
+    }
+};
+
+/** A single GDS record, pointing into the bytes owned by a record_cursor.
+ */
+struct record_view {
+    record_type type = record_type::ENDLIB;
+    const char *data = nullptr;
+    std::size_t size = 0;
+
+    /** Checks that this record has the given type and size, and returns the number of units.
+     *
+     *  @param rtype the expected record type.
+     *  @param unit_size the size of each unit of data.
+     *  @param num_data the expected number of units, 0 to accept any number.
+     */
+    std::size_t check(record_type rtype, std::size_t unit_size = 1,
+                      std::size_t num_data = 0) const;
+
+    uint16_t get_uint16(std::size_t idx = 0) const noexcept {
+        return decode_bytes<uint16_t>(data + 2 * idx);
+    }
+
+    int32_t get_int32(std::size_t idx = 0) const noexcept { return decode_int32(data + 4 * idx); }
+
+    uint64_t get_uint64(std::size_t idx = 0) const noexcept {
+        return decode_bytes<uint64_t>(data + 8 * idx);
+    }
+
+    /** Returns the payload as a string, including any padding byte, like the stream reader.
+     */
+    std::string_view get_string() const noexcept { return {data, size}; }
+
+    xy_span get_xy() const noexcept { return {data, size / 8}; }
+};
+
+/** Iterates over the records of a GDS file held in memory.
+ *
+ *  The file is memory-mapped when the platform supports it, otherwise it is read into a buffer
+ *  with one bulk read.  Records are decoded directly from those bytes, and record_view objects
+ *  stay valid for the lifetime of the cursor.
+ */
+class record_cursor {
+  private:
+    void *map_ptr = nullptr;
+    std::size_t map_size = 0;
+    std::vector<char> buffer;
+    const char *start = nullptr;
+    std::size_t total = 0;
+    std::size_t pos = 0;
+
+    struct helper;
+
+    record_cursor();
+
+  public:
+    /** Opens the given GDS file.
+     *
+     *  @param fname the file name.
+     *  @param use_mmap true to memory-map the file if possible.  If false, or if mapping fails,
+     *  the file is read into a buffer instead.
+     */
+    explicit record_cursor(const std::string &fname, bool use_mmap = true);
+
+    /** Reads all remaining bytes of the given stream into a buffer.
+     */
+    explicit record_cursor(std::istream &stream);
+
+    explicit record_cursor(std::vector<char> &&data);
+
+    record_cursor(const record_cursor &) = delete;
+
+    record_cursor &operator=(const record_cursor &) = delete;
+
+    record_cursor(record_cursor &&other) noexcept;
+
+    record_cursor &operator=(record_cursor &&other) noexcept;
+
+    ~record_cursor();
+
+    bool is_mapped() const noexcept;
+
+    bool at_end() const noexcept;
+
+    const char *data() const noexcept;
+
+    std::size_t size() const noexcept;
+
+    std::size_t tell() const noexcept;
+
+    void seek(std::size_t offset);
+
+    /** Returns a cursor over the bytes in [offset, stop) that does not own them.
+     *
+     *  The returned cursor must not outlive this cursor.  Slices have independent positions, so
+     *  separate threads can read different slices of the same file.
+     */
+    record_cursor slice(std::size_t offset, std::size_t stop) const;
+
+    /** Returns the next record without consuming it.
+     */
+    record_view peek() const;
+
+    /** Returns the next record and advances past it.
+     */
+    record_view next();
+
+    /** Returns the next record and advances past it, checking its type and size.
+     */
+    record_view next(record_type rtype, std::size_t unit_size = 1, std::size_t num_data = 0);
+};
+
+/** Copies records from the stream into a buffer until a record of the given type is copied.
+ *
+ *  This lets code built on record_cursor read a section of an input stream, leaving the stream
+ *  positioned right after that section.
+ */
+std::vector<char> read_records_until(std::istream &stream, record_type stop);
+
+} // namespace gdsii
+} // namespace cbag
+
+#endif
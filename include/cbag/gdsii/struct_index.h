@@ -0,0 +1,87 @@
+#ifndef CBAG_GDSII_STRUCT_INDEX_H
+#define CBAG_GDSII_STRUCT_INDEX_H
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cbag/logging/logging.h>
+
+namespace cbag {
+namespace gdsii {
+
+class record_cursor;
+
+/** The location of a GDS structure and the structures it instantiates.
+ */
+struct struct_info {
+    std::string name;
+    // byte range of the structure, from its STRNAME record to the end of its ENDSTR record.
+    std::size_t start = 0;
+    std::size_t stop = 0;
+    // indices of the instantiated structures, sorted and unique.
+    std::vector<std::size_t> deps;
+};
+
+/** An index of all structures in a GDS file.
+ *
+ *  The index is built by one pass over the record headers, without parsing any elements, so
+ *  structures can later be parsed in any order.  References to cells that are not in the file
+ *  are not recorded; reading the referencing structure reports them.
+ */
+class struct_index {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  private:
+    std::string lib_name;
+    std::vector<struct_info> info_list;
+    std::unordered_map<std::string, std::size_t> name_map;
+
+    struct helper;
+
+  public:
+    /** Scans the whole file.  The position of the cursor is restored afterwards.
+     */
+    struct_index(spdlog::logger &logger, record_cursor &cursor);
+
+    const std::string &get_lib_name() const noexcept;
+
+    std::size_t size() const noexcept;
+
+    const struct_info &operator[](std::size_t idx) const;
+
+    /** Returns the index of the structure with the given name, or npos.
+     *
+     *  If several structures have the same name, the first one is returned.
+     */
+    std::size_t find(const std::string &name) const;
+
+    /** Returns the given structure and every structure it instantiates, directly or not.
+     *
+     *  @return the structure indices, in file order.
+     */
+    std::vector<std::size_t> get_closure(std::size_t idx) const;
+
+    /** Groups all structures into waves that can be parsed concurrently.
+     *
+     *  Every structure appears after all structures it instantiates, and each wave is in file
+     *  order.  Throws if the instance hierarchy has a cycle.
+     */
+    std::vector<std::vector<std::size_t>> get_waves() const;
+
+    /** Groups the given structures into waves that can be parsed concurrently.
+     *
+     *  @param idx_list the structure indices, sorted.  Every structure instantiated by one of
+     *  them must also be in the list, as is the case for the result of get_closure().
+     */
+    std::vector<std::vector<std::size_t>>
+    get_waves(const std::vector<std::size_t> &idx_list) const;
+};
+
+} // namespace gdsii
+} // namespace cbag
+
+#endif
@@ -15,6 +15,7 @@
 #include <cbag/common/layer_t.h>
 #include <cbag/enum/boundary_type.h>
 #include <cbag/gdsii/typedefs.h>
+#include <cbag/gdsii/write_buffer.h>
 #include <cbag/layout/cellview_fwd.h>
 #include <cbag/layout/tech.h>
 
@@ -40,26 +41,39 @@ class gds_lookup {
 
 std::vector<tval_t> get_gds_time();
 
+void write_gds_start(spdlog::logger &logger, write_buffer &buf, const std::string &lib_name,
+                     double resolution, double user_unit, const std::vector<tval_t> &time_vec);
+
 void write_gds_start(spdlog::logger &logger, std::ostream &stream, const std::string &lib_name,
                      double resolution, double user_unit, const std::vector<tval_t> &time_vec);
 
+void write_gds_stop(spdlog::logger &logger, write_buffer &buf);
+
 void write_gds_stop(spdlog::logger &logger, std::ostream &stream);
 
+void write_lay_cellview(spdlog::logger &logger, write_buffer &buf, const std::string &cell_name,
+                        const cbag::layout::cellview &cv,
+                        const std::unordered_map<std::string, std::string> &rename_map,
+                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup,
+                        std::size_t num_workers = 0);
+
 void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
                         const cbag::layout::cellview &cv,
                         const std::unordered_map<std::string, std::string> &rename_map,
-                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup);
+                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup,
+                        std::size_t num_workers = 0);
 
 template <class Vector>
 void implement_gds(const std::string &fname, const std::string &lib_name,
                    const std::string &layer_map, const std::string &obj_map, double resolution,
-                   double user_unit, const Vector &cv_list) {
+                   double user_unit, const Vector &cv_list, std::size_t num_workers = 0) {
     auto logger = get_cbag_logger();
     auto time_vec = get_gds_time();
 
-    // get gds file stream
+    // get gds file stream; all cells share one output buffer
     auto stream = util::open_file_write(fname, true);
-    write_gds_start(*logger, stream, lib_name, resolution, user_unit, time_vec);
+    write_buffer buf(stream);
+    write_gds_start(*logger, buf, lib_name, resolution, user_unit, time_vec);
 
     // get first element and setup gds_lookup
     auto cursor = cv_list.begin();
@@ -71,14 +85,15 @@ void implement_gds(const std::string &fname, const std::string &lib_name,
             auto &[cv_cell_name, cv_ptr] = *cursor;
             const auto &cell_name = cv_ptr->get_name();
             logger->info("Creating layout cell {}", cv_cell_name);
-            write_lay_cellview(*logger, stream, cv_cell_name, *cv_ptr, rename_map, time_vec,
-                               lookup);
+            write_lay_cellview(*logger, buf, cv_cell_name, *cv_ptr, rename_map, time_vec, lookup,
+                               num_workers);
             logger->info("cell name {} maps to {}", cell_name, cv_cell_name);
             rename_map[cell_name] = cv_cell_name;
         }
     }
 
-    write_gds_stop(*logger, stream);
+    write_gds_stop(*logger, buf);
+    buf.flush();
     stream.close();
 }
 
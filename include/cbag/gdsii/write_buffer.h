@@ -0,0 +1,78 @@
+#ifndef CBAG_GDSII_WRITE_BUFFER_H
+#define CBAG_GDSII_WRITE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace cbag {
+namespace gdsii {
+
+/** Encodes a big-endian unsigned integer into the given bytes.
+ */
+template <typename T> void encode_bytes(char *data, T val) noexcept {
+    auto ptr = reinterpret_cast<unsigned char *>(data);
+    for (std::size_t bidx = sizeof(T); bidx > 0; --bidx, val >>= 8) {
+        ptr[bidx - 1] = static_cast<unsigned char>(val & 0xff);
+    }
+}
+
+inline void encode_int32(char *data, int32_t val) noexcept {
+    encode_bytes(data, static_cast<uint32_t>(val));
+}
+
+/** A contiguous output buffer in front of a GDS output stream.
+ *
+ *  Record writers encode directly into the buffer, and the buffer is written to the stream in
+ *  large blocks.  Storage grows with the data written, up to the capacity.  The buffer is
+ *  flushed when it is full, when flush() is called, and on destruction.
+ */
+class write_buffer {
+  public:
+    static constexpr std::size_t default_capacity = 1 << 20;
+
+  private:
+    std::ostream &stream;
+    std::vector<char> data;
+    std::size_t capacity = 0;
+    std::size_t pos = 0;
+
+  public:
+    explicit write_buffer(std::ostream &stream, std::size_t capacity = default_capacity);
+
+    write_buffer(const write_buffer &) = delete;
+
+    write_buffer &operator=(const write_buffer &) = delete;
+
+    ~write_buffer();
+
+    std::size_t size() const noexcept { return pos; }
+
+    /** Writes all buffered bytes to the stream.
+     */
+    void flush();
+
+    /** Returns a pointer to num bytes of free space, and marks them as used.
+     *
+     *  The buffer is flushed first if it does not have enough free space, and grows if num is
+     *  larger than its capacity.
+     */
+    char *claim(std::size_t num) {
+        if (data.size() - pos < num)
+            make_room(num);
+        auto ans = data.data() + pos;
+        pos += num;
+        return ans;
+    }
+
+    template <typename T> void put(T val) { encode_bytes(claim(sizeof(T)), val); }
+
+  private:
+    void make_room(std::size_t num);
+};
+
+} // namespace gdsii
+} // namespace cbag
+
+#endif
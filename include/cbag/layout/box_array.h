@@ -0,0 +1,45 @@
+#ifndef CBAG_LAYOUT_BOX_ARRAY_H
+#define CBAG_LAYOUT_BOX_ARRAY_H
+
+#include <cbag/common/box_t.h>
+
+namespace cbag {
+namespace layout {
+
+/** An nx by ny array of rectangles with pitch (spx, spy).
+ *
+ *  Element (ix, iy) is base moved by (ix * spx, iy * spy).
+ */
+struct box_array {
+  public:
+    box_t base;
+    cnt_t nx = 1;
+    cnt_t ny = 1;
+    offset_t spx = 0;
+    offset_t spy = 0;
+
+    box_array();
+
+    box_array(box_t base, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy);
+
+    bool operator==(const box_array &rhs) const noexcept;
+
+    bool empty() const noexcept;
+
+    box_t get_box(cnt_t ix, cnt_t iy) const;
+
+    box_t get_bbox() const;
+
+    template <typename F> void for_each(F fun) const {
+        for (cnt_t ix = 0; ix < nx; ++ix) {
+            for (cnt_t iy = 0; iy < ny; ++iy) {
+                fun(get_box(ix, iy));
+            }
+        }
+    }
+};
+
+} // namespace layout
+} // namespace cbag
+
+#endif
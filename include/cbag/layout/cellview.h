@@ -8,5 +8,50 @@
 #include <cbag/layout/pin.h>
 #include <cbag/layout/tech.h>
 #include <cbag/layout/via.h>
+#include <cbag/layout/via_array.h>
+
+namespace cbag {
+namespace layout {
+
+template <typename F> void cellview::for_each_via(F fun) const {
+    auto pos_iter = via_arr_pos_list.begin();
+    auto arr_iter = via_arr_list.begin();
+    auto arr_end = via_arr_list.end();
+    for (std::size_t idx = 0, num = via_list.size(); idx <= num; ++idx) {
+        for (; arr_iter != arr_end && *pos_iter == idx; ++arr_iter, ++pos_iter) {
+            arr_iter->for_each(fun);
+        }
+        if (idx < num)
+            fun(via_list[idx]);
+    }
+}
+
+/** Keeps the spatial indices of a cellview in bulk mode for the lifetime of this object.
+ *
+ *  All shapes and instances added during the session are indexed with a single packed R-tree
+ *  build when the session ends.
+ */
+class build_session {
+  private:
+    cellview *parent = nullptr;
+
+  public:
+    explicit build_session(cellview &cv) : parent(&cv) { parent->set_bulk_mode(true); }
+
+    build_session(const build_session &) = delete;
+    build_session &operator=(const build_session &) = delete;
+
+    ~build_session() { finalize(); }
+
+    void finalize() {
+        if (parent != nullptr) {
+            parent->set_bulk_mode(false);
+            parent = nullptr;
+        }
+    }
+};
+
+} // namespace layout
+} // namespace cbag
 
 #endif
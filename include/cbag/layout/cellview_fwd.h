@@ -1,18 +1,23 @@
 #ifndef CBAG_LAYOUT_CELLVIEW_FWD_H
 #define CBAG_LAYOUT_CELLVIEW_FWD_H
 
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/container_hash/hash.hpp>
 
+#include <cbag/common/box_t.h>
 #include <cbag/common/layer_t.h>
 #include <cbag/common/transformation_fwd.h>
 #include <cbag/enum/geometry_mode.h>
+#include <cbag/layout/box_array.h>
 #include <cbag/layout/geo_index.h>
 #include <cbag/layout/geometry.h>
 #include <cbag/layout/instance.h>
+#include <cbag/layout/track_occupancy.h>
+#include <cbag/util/hash128.h>
 
 namespace cbag {
 
@@ -24,17 +29,29 @@ class boundary;
 class blockage;
 class pin;
 class via;
+class via_array;
 class via_wrapper;
 class routing_grid;
 class tech;
 class label;
 class track_id;
+class wire_array;
 
 using geo_map_t = std::unordered_map<layer_t, geometry, boost::hash<layer_t>>;
 using block_map_t = std::unordered_map<lay_t, std::vector<blockage>>;
 using pin_map_t = std::unordered_map<lay_t, std::vector<pin>>;
 using inst_map_t = std::unordered_map<std::string, instance>;
-
+using bbox_map_t = std::unordered_map<layer_t, box_t, boost::hash<layer_t>>;
+
+/** A layout cellview.
+ *
+ *  Several const methods fill caches on first use: the per-layer bounding boxes, the merged
+ *  region and region hash of each geometry, and the track occupancy.  Concurrent const access
+ *  to the same cellview is therefore only safe through the geometry indices (get_geo_index()),
+ *  whose deferred build is locked.  Other const queries from multiple threads must be
+ *  synchronized by the caller, or the caches warmed first with get_bbox(), get_content_hash()
+ *  and get_track_occupancy().
+ */
 class cellview {
   private:
     cnt_t inst_name_cnt = 0;
@@ -46,10 +63,24 @@ class cellview {
     inst_map_t inst_map;
     pin_map_t pin_map;
     std::vector<via> via_list;
+    std::vector<via_array> via_arr_list;
+    // number of single vias added before each via array, to preserve the via order.
+    std::vector<std::size_t> via_arr_pos_list;
     block_map_t lay_block_map;
     std::vector<blockage> area_block_list;
     std::vector<boundary> boundary_list;
     std::vector<label> label_list;
+    // single-element indices of arrayed rectangles; shared so copies remain valid.
+    std::vector<std::shared_ptr<const geo_index>> arr_index_list;
+    // hierarchical bounding box per layer, filled lazily.
+    // NOTE: masters must not be modified after they are instantiated.
+    mutable bbox_map_t bbox_cache;
+    // order-independent hash of all objects added so far, except shapes.
+    util::hash128 content_hash;
+    // blocked half-tracks of shapes drawn directly in this cellview, built lazily per level.
+    mutable track_occupancy occupancy;
+    // size of each level's geometry index when its occupancy was last built.
+    mutable std::vector<std::size_t> occ_size_list;
 
     struct helper;
 
@@ -59,8 +90,30 @@ class cellview {
 
     bool operator==(const cellview &rhs) const noexcept;
 
+    /** Returns true if the two cellviews have the same content, ignoring cell names.
+     *
+     *  Content is compared by the 128-bit content hash only.  Hash collisions are not checked
+     *  for: two cellviews with equal hashes are treated as equal.  The order in which objects
+     *  were added does not affect the result.
+     */
+    bool content_equal(const cellview &rhs) const noexcept;
+
+    /** Returns the 128-bit content hash.
+     *
+     *  Objects other than shapes are hashed as they are added.  Each layer contributes the
+     *  hash of its merged region, which every geometry computes lazily and caches, so reading
+     *  the hash costs one lookup per layer once the layers are merged.
+     */
+    util::hash128 get_content_hash() const;
+
+    std::size_t get_hash() const;
+
     void set_geometry_mode(geometry_mode new_mode);
 
+    bool is_bulk_mode() const noexcept;
+
+    void set_bulk_mode(bool val);
+
     auto find_geometry(layer_t key) const -> decltype(geo_map.find(key));
 
     const std::string &get_name() const noexcept;
@@ -69,19 +122,37 @@ class cellview {
 
     bool empty() const noexcept;
 
+    box_t get_bbox(layer_t key) const;
+
     const geo_index &get_geo_index(level_t lev) const;
+
+    /** Returns the half-track occupancy of the routing levels.
+     *
+     *  Only shapes added directly to this cellview are recorded; shapes of instances are not.
+     *  The occupancy is built from the geometry indices on demand, so levels that changed since
+     *  the last call are rebuilt.  Call this method again after adding shapes.
+     */
+    const track_occupancy &get_track_occupancy() const;
+
     auto begin_inst() const -> decltype(inst_map.cbegin());
     auto end_inst() const -> decltype(inst_map.cend());
     auto begin_geometry() const -> decltype(geo_map.cbegin());
     auto end_geometry() const -> decltype(geo_map.cend());
     auto begin_via() const -> decltype(via_list.cbegin());
     auto end_via() const -> decltype(via_list.cend());
+    auto begin_via_arr() const -> decltype(via_arr_list.cbegin());
+    auto end_via_arr() const -> decltype(via_arr_list.cend());
     auto begin_lay_block() const -> decltype(lay_block_map.cbegin());
     auto end_lay_block() const -> decltype(lay_block_map.cend());
     auto begin_area_block() const -> decltype(area_block_list.cbegin());
     auto end_area_block() const -> decltype(area_block_list.cend());
     auto begin_boundary() const -> decltype(boundary_list.cbegin());
     auto end_boundary() const -> decltype(boundary_list.cend());
+
+    /** Calls fun on every via in the order they were added, expanding via arrays.
+     */
+    template <typename F> void for_each_via(F fun) const;
+
     auto begin_pin() const -> decltype(pin_map.cbegin());
     auto end_pin() const -> decltype(pin_map.cend());
     auto begin_label() const -> decltype(label_list.cbegin());
@@ -97,11 +168,30 @@ class cellview {
     void add_object(const via_wrapper &obj);
     void add_object(const instance &obj);
     void add_shape(layer_t key, const box_t &obj);
+    void add_shape(layer_t key, const box_array &obj);
     void add_shape(layer_t key, const polygon90 &obj);
     void add_shape(layer_t key, const polygon45 &obj);
     void add_shape(layer_t key, const polygon &obj);
     void add_shape(layer_t key, const polygon45_set &obj);
     void add_warr(const track_id &tid, std::array<offset_t, 2> coord);
+
+    /** Adds all rectangles of the given wire arrays in one batch.
+     *
+     *  Rectangles are grouped by layer and appended to each geometry in one pass, and each
+     *  affected geometry index is rebuilt once instead of once per rectangle.  The result is the
+     *  same as calling add_warr() on every wire array in order.
+     *
+     *  @param warr_list the wire arrays.
+     *  @param num_rect_hint the expected total number of rectangles, used to reserve storage.
+     *  0 means use the number of wire arrays.
+     */
+    void add_warrs(const std::vector<wire_array> &warr_list, std::size_t num_rect_hint = 0);
+
+    /** Adds an array of vias, stored as a single object.
+     *
+     *  If add_layers is true, the via enclosures are added as rectangle arrays.
+     */
+    void add_via_arr(const via_array &obj, bool add_layers);
 };
 
 } // namespace layout
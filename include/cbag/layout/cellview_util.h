@@ -14,6 +14,16 @@ template <typename T> class cv_obj_ref;
 
 box_t get_bbox(const cellview &cv, const std::string &layer, const std::string &purpose);
 
+/** Merges the geometries on all layers of the given cellview concurrently.
+ *
+ *  The merged results are cached in each geometry, so exporting the cellview afterwards does
+ *  not merge again.
+ *
+ *  @param cv the cellview.
+ *  @param num_workers number of worker threads.  0 means use all hardware threads.
+ */
+void merge_geometry(const cellview &cv, std::size_t num_workers = 0);
+
 void add_pin(cellview &cv, const std::string &layer, const std::string &net,
              const std::string &label, const box_t &bbox);
 
@@ -23,6 +33,10 @@ void add_pin_arr(cellview &cv, const std::string &net, const std::string &label,
 cv_obj_ref<via_wrapper> add_via(cellview &cv, transformation xform, std::string via_id,
                                 const via_param &params, bool add_layers, bool commit);
 
+void add_via_arr(cellview &cv, const transformation &xform, via_def_t vdef,
+                 const via_param &params, bool add_layers, std::array<cnt_t, 2> num_arr,
+                 std::array<offset_t, 2> sp_arr);
+
 void add_via_arr(cellview &cv, const transformation &xform, const std::string &via_id,
                  const via_param &params, bool add_layers, std::array<cnt_t, 2> num_arr,
                  std::array<offset_t, 2> sp_arr);
@@ -0,0 +1,41 @@
+#ifndef CBAG_LAYOUT_FLIP_PARITY_CACHE_H
+#define CBAG_LAYOUT_FLIP_PARITY_CACHE_H
+
+#include <array>
+#include <memory>
+
+#include <cbag/common/typedefs.h>
+#include <cbag/util/memo_cache.h>
+
+namespace cbag {
+namespace layout {
+
+class flip_parity;
+
+/** The arguments of a flip parity computation.
+ *
+ *  loc is the location of the transformation modulo the coloring period of the levels, so all
+ *  locations that give the same track coloring map to the same query.
+ */
+struct flip_parity_query {
+    level_t bot_level = 0;
+    level_t top_level = 0;
+    uint32_t orient = 0;
+    std::array<coord_t, 2> loc = {0, 0};
+
+    bool operator==(const flip_parity_query &rhs) const noexcept;
+};
+
+struct flip_parity_query_hash {
+    std::size_t operator()(const flip_parity_query &v) const;
+};
+
+/** A thread-safe cache of shared, immutable flip_parity objects.
+ */
+using flip_parity_cache = util::memo_cache<flip_parity_query, std::shared_ptr<const flip_parity>,
+                                           flip_parity_query_hash>;
+
+} // namespace layout
+} // namespace cbag
+
+#endif
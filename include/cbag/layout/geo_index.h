@@ -1,6 +1,12 @@
 #ifndef CBAG_LAYOUT_GEO_INDEX_H
 #define CBAG_LAYOUT_GEO_INDEX_H
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
 #include <cbag/common/layer_t.h>
 #include <cbag/common/transformation_fwd.h>
 #include <cbag/layout/geo_index_impl.h>
@@ -15,27 +21,112 @@ namespace layout {
 class tech;
 class geo_iterator;
 
+/** A lightweight view of a flat geometry reported by geo_index::visit_intersect().
+ *
+ *  bbox is in the coordinates of the geo_index that owns the object; xform maps it to the
+ *  coordinates of the query.
+ */
+struct geo_view {
+    const geo_object &obj;
+    geo_union_enum kind;
+    box_t bbox;
+    const cbag::transformation &xform;
+    offset_t spx;
+    offset_t spy;
+};
+
+/** A spatial index of layout objects on a single routing level.
+ *
+ *  In bulk mode, inserted objects are buffered and the R-tree is built with the packing
+ *  algorithm the first time the index is queried or when bulk mode ends.
+ *
+ *  Const methods may be called concurrently from multiple threads: the deferred R-tree build
+ *  is done at most once, under a lock.  Methods that insert objects are not thread-safe.
+ */
 class geo_index {
   public:
     using const_iterator = geo_iterator;
 
   private:
-    geo_index_impl index;
+    using visit_fun_t = bool (*)(void *, const geo_view &);
+
+    mutable geo_index_impl index;
+    mutable std::vector<geo_object> buffer;
+    // true if buffer has objects not yet in the R-tree.
+    mutable std::atomic<bool> pending{false};
+    mutable std::mutex build_lock;
+    bool bulk_mode = false;
+
+    struct helper;
+
+    bool visit_intersect_impl(const box_t &r, offset_t spx, offset_t spy,
+                              const cbag::transformation &xform, visit_fun_t fn, void *data) const;
 
   public:
     geo_index();
 
+    geo_index(const geo_index &other);
+
+    geo_index(geo_index &&other) noexcept;
+
+    geo_index &operator=(const geo_index &other);
+
+    geo_index &operator=(geo_index &&other) noexcept;
+
     bool empty() const;
 
+    std::size_t size() const;
+
     box_t get_bbox() const;
 
+    bool is_bulk_mode() const noexcept;
+
+    void set_bulk_mode(bool val);
+
+    void reserve(std::size_t n);
+
+    void commit() const;
+
+    geo_query_iter qbegin(const box_t &r, offset_t spx, offset_t spy) const;
+
     const_iterator begin_intersect(const box_t &r, offset_t spx, offset_t spy,
                                    const cbag::transformation &xform) const;
 
-    void insert(const geo_index *master, const cbag::transformation &xform);
+    /** Calls fn on every flat geometry that intersects the given box.
+     *
+     *  Rectangles are reported if they intersect the query box expanded by the spacing; other
+     *  shapes are reported if their bounding box does.  fn returns true to stop the query.
+     *
+     *  @return true if fn stopped the query early.
+     */
+    template <typename F>
+    bool visit_intersect(const box_t &r, offset_t spx, offset_t spy,
+                         const cbag::transformation &xform, F &&fn) const {
+        using fun_t = std::remove_reference_t<F>;
+        return visit_intersect_impl(
+            r, spx, spy, xform,
+            [](void *data, const geo_view &v) -> bool { return (*static_cast<fun_t *>(data))(v); },
+            const_cast<void *>(static_cast<const void *>(std::addressof(fn))));
+    }
+
+    /** Calls fn on every object stored in this index, without descending into instances.
+     */
+    template <typename F> void for_each_object(F &&fn) const {
+        commit();
+        for (const auto &obj : index) {
+            fn(obj);
+        }
+    }
+
+    void insert(const geo_index *master, const cbag::transformation &xform, cnt_t nx = 1,
+                cnt_t ny = 1, offset_t spx = 0, offset_t spy = 0);
 
     template <typename T> void insert(T &&obj, offset_t spx, offset_t spy) {
-        index.insert(geo_object(std::forward<T>(obj), spx, spy));
+        if (bulk_mode) {
+            buffer.emplace_back(std::forward<T>(obj), spx, spy);
+            pending = true;
+        } else
+            index.insert(geo_object(std::forward<T>(obj), spx, spy));
     }
 };
 
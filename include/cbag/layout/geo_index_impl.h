@@ -11,6 +11,7 @@ namespace cbag {
 namespace layout {
 
 using geo_index_impl = bgi::rtree<geo_object, bgi::quadratic<32, 16>>;
+// NOTE: an exhausted query iterator compares equal to a default constructed one.
 using geo_query_iter = geo_index_impl::const_query_iterator;
 
 } // namespace layout
@@ -1,6 +1,8 @@
 #ifndef CBAG_LAYOUT_GEO_INSTANCE_H
 #define CBAG_LAYOUT_GEO_INSTANCE_H
 
+#include <array>
+
 #include <cbag/common/transformation.h>
 
 namespace cbag {
@@ -9,24 +11,47 @@ class box_t;
 
 namespace layout {
 
-class geo_iterator;
 class geo_index;
 
+/** An instance (or instance array) of a geo_index inside another geo_index.
+ *
+ *  Array element (ix, iy) is the master placed with xform, then moved by (ix * spx, iy * spy).
+ *  The whole array occupies a single entry in the parent index.
+ */
 class geo_instance {
   private:
     const geo_index *master = nullptr;
     transformation xform;
+    cnt_t nx = 1;
+    cnt_t ny = 1;
+    offset_t spx = 0;
+    offset_t spy = 0;
 
   public:
     geo_instance();
 
-    geo_instance(const geo_index *master, transformation xform);
+    geo_instance(const geo_index *master, transformation xform, cnt_t nx = 1, cnt_t ny = 1,
+                 offset_t spx = 0, offset_t spy = 0);
 
     bool empty() const;
 
+    const geo_index *get_master() const noexcept;
+
+    const transformation &get_xform() const noexcept;
+
+    transformation get_xform(cnt_t ix, cnt_t iy) const;
+
+    cnt_t get_nx() const noexcept;
+
+    cnt_t get_ny() const noexcept;
+
     box_t get_bbox() const;
 
-    geo_iterator begin_intersect(const box_t &r, offset_t spx, offset_t spy) const;
+    /** Returns the [start, stop) array index ranges in x and y of elements that may intersect
+     *  the given box expanded by the given spacing.
+     */
+    std::array<std::array<cnt_t, 2>, 2> get_index_range(const box_t &r, offset_t spx,
+                                                        offset_t spy) const;
 
     bool operator==(const geo_instance &rhs) const;
 };
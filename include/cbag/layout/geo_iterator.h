@@ -1,9 +1,10 @@
 #ifndef CBAG_LAYOUT_GEO_ITERATOR_H
 #define CBAG_LAYOUT_GEO_ITERATOR_H
 
+#include <array>
 #include <iterator>
-#include <memory>
 #include <utility>
+#include <vector>
 
 #include <cbag/common/box_t.h>
 #include <cbag/layout/geo_index_impl.h>
@@ -11,13 +12,6 @@
 namespace cbag {
 namespace layout {
 
-enum geo_union_enum : enum_t {
-    RECT = 0,
-    POLY90 = 1,
-    POLY45 = 2,
-    POLY = 3,
-};
-
 class geo_union {
   public:
     std::variant<box_t, polygon90, polygon45, polygon> val;
@@ -33,6 +27,75 @@ class geo_union {
     geo_union_enum index() const { return static_cast<geo_union_enum>(val.index()); }
 };
 
+/** A depth-first traversal of the objects in a geo_index hierarchy that may intersect a query box.
+ *
+ *  Instance hierarchies are traversed with an explicit stack of frames.  Each frame stores the
+ *  R-tree query iterator of one hierarchy level together with the transformation from that level
+ *  to the top level, so descending into an instance does not allocate a nested iterator and every
+ *  shape is transformed exactly once.  The first inline_depth frames are stored inline; deeper
+ *  hierarchies spill the remaining frames to the heap.
+ *
+ *  The traversal stops at every object that is not an instance; the caller tests it against the
+ *  query box of its frame and calls skip() to move on.
+ */
+class geo_traversal {
+  public:
+    static constexpr std::size_t inline_depth = 32;
+
+    struct frame {
+        // the query box and spacing, in the coordinates of this level
+        box_t box;
+        offset_t spx = 0;
+        offset_t spy = 0;
+        geo_query_iter cur;
+        // transformation from this level to the top level
+        cbag::transformation xform;
+        // the instance array this frame iterates over, null for the root frame
+        const geo_instance *inst = nullptr;
+        std::array<cnt_t, 2> idx = {0, 0};
+        std::array<cnt_t, 2> start = {0, 0};
+        std::array<cnt_t, 2> stop = {0, 0};
+
+        bool operator==(const frame &rhs) const;
+    };
+
+  private:
+    std::array<frame, inline_depth> stack;
+    // frames below the first inline_depth levels.
+    std::vector<frame> spill;
+    std::size_t depth = 0;
+    struct helper;
+
+    frame &get_frame(std::size_t lev);
+    const frame &get_frame(std::size_t lev) const;
+
+  public:
+    geo_traversal();
+
+    geo_traversal(const box_t &box, offset_t spx, offset_t spy, geo_query_iter &&cur,
+                  const cbag::transformation &xform);
+
+    bool has_next() const;
+
+    /** Moves to the next object that is not an instance, starting from the current object.
+     *
+     *  @return false if there are no objects left.
+     */
+    bool find_leaf();
+
+    /** Returns the frame of the current object.
+     */
+    const frame &top() const;
+
+    /** Moves past the current object.
+     */
+    void skip();
+
+    bool operator==(const geo_traversal &rhs) const;
+};
+
+/** An iterator over all flat geometries in a geo_index that intersect a query box.
+ */
 class geo_iterator {
   public:
     using flat_geo_type = geo_union;
@@ -43,13 +106,7 @@ class geo_iterator {
     using reference = value_type &;
 
   private:
-    box_t box;
-    offset_t spx = 0;
-    offset_t spy = 0;
-    geo_query_iter cur;
-    geo_query_iter end;
-    cbag::transformation xform;
-    std::shared_ptr<geo_iterator> inner = nullptr;
+    geo_traversal trav;
     flat_geo_type cur_val;
     struct helper;
 
@@ -57,7 +114,7 @@ class geo_iterator {
     geo_iterator();
 
     geo_iterator(const box_t &box, offset_t spx, offset_t spy, geo_query_iter &&cur,
-                 geo_query_iter &&end, const cbag::transformation &xform);
+                 const cbag::transformation &xform);
 
     bool has_next() const;
 
@@ -21,6 +21,13 @@ namespace layout {
 using bg_point = bg::model::point<coord_t, 2, bg::cs::cartesian>;
 using bg_box = bg::model::box<bg_point>;
 
+enum geo_union_enum : enum_t {
+    RECT = 0,
+    POLY90 = 1,
+    POLY45 = 2,
+    POLY = 3,
+};
+
 class geo_object {
   public:
     using value_type = std::variant<box_t, polygon90, polygon45, polygon, geo_instance>;
@@ -37,6 +44,8 @@ class geo_object {
     bool operator==(const geo_object &v) const;
 
     const geo_instance *get_instance() const;
+
+    box_t get_bbox() const;
 };
 
 bg_box get_bnd_box(const geo_object::value_type &val, offset_t spx, offset_t spy);
@@ -2,12 +2,16 @@
 #define CBAG_LAYOUT_GEOMETRY_H
 
 #include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <variant>
 #include <vector>
 
+#include <cbag/common/box_t.h>
 #include <cbag/common/layer_t.h>
 #include <cbag/common/transformation.h>
 #include <cbag/enum/geometry_mode.h>
+#include <cbag/layout/box_array.h>
 #include <cbag/layout/geo_index.h>
 #include <cbag/layout/polygon45_fwd.h>
 #include <cbag/layout/polygon45_set_fwd.h>
@@ -15,27 +19,42 @@
 #include <cbag/layout/polygon90_set_fwd.h>
 #include <cbag/layout/polygon_fwd.h>
 #include <cbag/layout/polygon_set.h>
+#include <cbag/util/hash128.h>
 #include <cbag/util/overload.h>
 
 namespace bgi = boost::geometry::index;
 
 namespace cbag {
-
-class box_t;
-
 namespace layout {
 
 class tech;
 class routing_grid;
 
 /** A class representing layout geometries on the same layer.
+ *
+ *  Rectangles are stored in a plain vector until a non-rectangular shape is added, at which
+ *  point the data is converted to the polygon set corresponding to the geometry mode.
+ *  Rectangle arrays are likewise kept in compact form and only expanded when merging.
+ *
+ *  The merged polygon set and its region hash are computed lazily and cached until the next
+ *  shape is added, so repeated exports, bounding box queries and hashes only merge once.
+ *  Because of these caches, a geometry object must not be read from multiple threads
+ *  concurrently.
  */
 class geometry {
   private:
-    using geometry_data = std::variant<polygon90_set, polygon45_set, polygon_set>;
+    using box_list = std::vector<box_t>;
+    using geometry_data = std::variant<box_list, polygon90_set, polygon45_set, polygon_set>;
 
     geometry_mode mode;
     geometry_data data;
+    // rectangle arrays; only used when data is a box_list.
+    std::vector<box_array> arr_list;
+    // merged rectangles; only used when data is a box_list.
+    mutable geometry_data merged;
+    mutable bool dirty = true;
+    // hash of the merged region; reset whenever the merged set is recomputed.
+    mutable std::optional<util::hash128> region_hash;
     struct helper;
 
   public:
@@ -43,24 +62,52 @@ class geometry {
 
     bool operator==(const geometry &rhs) const noexcept;
 
+    bool is_rect_only() const noexcept;
+
     box_t get_bbox() const;
 
+    /** Computes and caches the merged polygon set.
+     *
+     *  Different geometry objects can be merged concurrently.
+     */
+    void merge() const;
+
+    /** Returns a hash of the merged region.
+     *
+     *  The hash is computed from the canonical merged polygon set, so geometries that cover
+     *  the same region have the same hash, no matter how the region was drawn.
+     */
+    util::hash128 get_region_hash() const;
+
     void reset_to_mode(geometry_mode m);
 
     void add_shape(const box_t &obj);
+    void add_shape(const box_array &obj);
     void add_shape(const polygon90 &obj);
     void add_shape(const polygon45 &obj);
     void add_shape(const polygon &obj);
     void add_shape(const polygon45_set &obj);
 
-    template <typename T> void write_geometry(T &output) const {
+    /** Adds all the given rectangles, growing the rectangle list at most once.
+     */
+    void add_shapes(const std::vector<box_t> &obj_list);
+
+    template <typename T> void write_geometry(T &output) const { write_data(get_merged(), output); }
+
+  private:
+    const geometry_data &get_merged() const;
+
+    template <typename T> static void write_data(const geometry_data &d, T &output) {
         std::visit(
             overload{
+                [](const box_list &d) {
+                    throw std::invalid_argument("Cannot write rectangles directly.");
+                },
                 [&output](const polygon90_set &d) { d.get(output); },
                 [&output](const polygon45_set &d) { d.get(output); },
                 [&output](const polygon_set &d) { d.get(output); },
             },
-            data);
+            d);
     }
 };
 
@@ -0,0 +1,181 @@
+#ifndef CBAG_LAYOUT_GRID_ROUTER_H
+#define CBAG_LAYOUT_GRID_ROUTER_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <cbag/common/box_t.h>
+#include <cbag/common/layer_t.h>
+#include <cbag/common/typedefs.h>
+#include <cbag/enum/orient_2d.h>
+#include <cbag/layout/via_def.h>
+#include <cbag/util/indexed_heap.h>
+
+namespace cbag {
+namespace layout {
+
+class cellview;
+
+/** A node of the routing lattice: a point on a full track of a routing level.
+ *
+ *  coord is the coordinate along the track direction.
+ */
+struct route_point {
+    level_t level = 0;
+    htr_t htr = 0;
+    offset_t coord = 0;
+
+    bool operator==(const route_point &rhs) const noexcept {
+        return level == rhs.level && htr == rhs.htr && coord == rhs.coord;
+    }
+};
+
+/** A single-track wire between two lattice nodes, measured center to center.
+ */
+struct route_wire {
+    level_t level = 0;
+    htr_t htr = 0;
+    std::array<offset_t, 2> coord = {0, 0};
+
+    bool operator==(const route_wire &rhs) const noexcept {
+        return level == rhs.level && htr == rhs.htr && coord == rhs.coord;
+    }
+};
+
+/** A via between the given level and the level above, at the crossing of the two tracks.
+ */
+struct route_via {
+    level_t level = 0;
+    htr_t htr = 0;
+    htr_t adj_htr = 0;
+
+    bool operator==(const route_via &rhs) const noexcept {
+        return level == rhs.level && htr == rhs.htr && adj_htr == rhs.adj_htr;
+    }
+};
+
+struct route_result {
+    bool success = false;
+    int_fast64_t cost = 0;
+    std::vector<route_wire> wires;
+    std::vector<route_via> vias;
+};
+
+/** A maze router that searches the half-track lattice of a routing grid with A*.
+ *
+ *  The lattice nodes of a routing level are the full tracks of that level inside the routing
+ *  bounds, crossed with the track centers of the orthogonal levels directly above and below it.
+ *  Moving along a track costs its length, and changing level costs a fixed via cost.
+ *
+ *  Single-track wire segments and vias are checked against the geometry index of the cellview,
+ *  including the spacing margins of both the new and existing shapes, and vias must have a
+ *  legal solution from the technology.  Obstacle checks are evaluated lazily and cached for the
+ *  duration of one route() call, so a route() call always sees the current cellview content.
+ *  Minimum length rules are not considered.
+ *
+ *  Existing shapes of the net being routed, such as terminal pins or previously drawn wires,
+ *  can be passed to route() as net boxes; shapes on the same level that lie inside a net box
+ *  are not obstacles.  Ties between equal cost paths are broken by node index, so results are
+ *  deterministic.
+ */
+class grid_router {
+  public:
+    using cost_t = int_fast64_t;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  private:
+    struct level_info {
+        orient_2d dir = orient_2d::HORIZONTAL;
+        htr_t htr0 = 0;
+        std::size_t offset = 0;
+        // coordinates of the tracks and of the stops along each track, both sorted.
+        std::vector<offset_t> tr_coords;
+        std::vector<offset_t> stops;
+        // per stop: index of the crossing track on the level below/above, or npos.
+        std::vector<std::size_t> dn_tr;
+        std::vector<std::size_t> up_tr;
+        // per track: index of the stop of this track on the level below/above, or npos.
+        std::vector<std::size_t> dn_stop;
+        std::vector<std::size_t> up_stop;
+    };
+
+    const cellview *cv_ptr = nullptr;
+    level_t bot_level = 0;
+    cost_t via_cost = 0;
+    std::size_t num_nodes = 0;
+    std::vector<level_info> lev_list;
+    std::map<std::pair<layer_t, layer_t>, std::optional<via_def_t>> vdef_cache;
+    // per level: boxes of the shapes of the net being routed.
+    std::vector<std::vector<box_t>> net_list;
+
+    // lazily evaluated obstacle states of the wire to the next stop and of the via above.
+    std::vector<uint8_t> wire_state;
+    std::vector<uint8_t> via_state;
+
+    // search state; an entry is valid only if its stamp equals the current search stamp.
+    uint32_t cur_stamp = 0;
+    std::vector<uint32_t> open_stamp;
+    std::vector<uint32_t> closed_stamp;
+    std::vector<uint8_t> target_mark;
+    std::vector<cost_t> g_list;
+    std::vector<std::size_t> parent_list;
+    util::indexed_heap<std::array<cost_t, 2>> heap;
+
+    struct helper;
+
+  public:
+    /** Creates a router for the given levels and bounds.
+     *
+     *  @param cv the cellview whose shapes are obstacles.
+     *  @param bot_level the bottom routing level.
+     *  @param top_level the top routing level.
+     *  @param bnds the routing bounds.  Only tracks and stops whose centers lie in the bounds are
+     *  lattice nodes.
+     *  @param via_cost the cost of each via, in resolution units of wire length.
+     */
+    grid_router(const cellview &cv, level_t bot_level, level_t top_level, const box_t &bnds,
+                cost_t via_cost);
+
+    std::size_t get_num_nodes() const noexcept;
+
+    /** Returns true if the given point is a node of the routing lattice.
+     */
+    bool is_node(const route_point &pt) const;
+
+    /** Finds the cheapest route between two lattice nodes.
+     *
+     *  @param net_boxes the (level, box) pairs of existing shapes of the net being routed.
+     */
+    route_result route(const route_point &src, const route_point &dst,
+                       const std::vector<std::pair<level_t, box_t>> &net_boxes = {});
+
+    /** Connects all terminals with a tree of shortest paths.
+     *
+     *  Starting from the first terminal, the nearest unconnected terminal is repeatedly
+     *  connected to the routed tree, using every node of the tree as a search source.
+     *
+     *  @param terms the terminals.
+     *  @param net_boxes the (level, box) pairs of existing shapes of the net being routed.
+     *  @return the route.  success is false if some terminal cannot be reached, in which case
+     *  no wires or vias are returned.
+     */
+    route_result route(const std::vector<route_point> &terms,
+                       const std::vector<std::pair<level_t, box_t>> &net_boxes = {});
+};
+
+/** Draws the given route in the cellview.
+ *
+ *  Wires are extended by half their width past their end nodes, and vias are drawn with their
+ *  metal enclosures.
+ */
+void add_route(cellview &cv, const route_result &ans);
+
+} // namespace layout
+} // namespace cbag
+
+#endif
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <variant>
 
+#include <cbag/common/layer_t.h>
 #include <cbag/common/param_map.h>
 #include <cbag/common/transformation.h>
 #include <cbag/common/typedefs.h>
@@ -68,6 +69,8 @@ class instance {
 
     const param_map *get_params() const;
 
+    box_t get_bbox(layer_t key) const;
+
     box_t get_bbox(const std::string &layer, const std::string &purpose) const;
 
     void set_master(const cellview *new_master);
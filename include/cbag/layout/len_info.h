@@ -22,6 +22,10 @@ class len_info {
 
     len_info(std::vector<max_len_data> &&w_al, std::vector<max_len_data> &&md_al);
 
+    const std::vector<max_len_data> &get_width_list() const noexcept;
+
+    const std::vector<max_len_data> &get_max_dim_list() const noexcept;
+
     offset_t get_min_length(offset_t w, bool even) const;
 };
 
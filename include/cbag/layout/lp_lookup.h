@@ -2,8 +2,15 @@
 #ifndef CBAG_COMMON_LP_LOOKUP_H
 #define CBAG_COMMON_LP_LOOKUP_H
 
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <cbag/common/layer_t.h>
 #include <cbag/common/typedefs.h>
 
 namespace YAML {
@@ -16,12 +23,39 @@ namespace layout {
 using lay_map_t = std::unordered_map<std::string, lay_t>;
 using purp_map_t = std::unordered_map<std::string, purp_t>;
 
+/** An ID-to-name index built from a name-to-ID map.
+ *
+ *  Small IDs are looked up directly in a dense vector.  IDs too large to store densely (such as
+ *  the drawing purpose, 4294967295) are kept in a sorted vector and binary searched.
+ */
+class id_name_index {
+  private:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    std::vector<std::string> name_list;
+    std::vector<uint32_t> dense_list;
+    std::vector<std::pair<uint32_t, uint32_t>> sparse_list;
+
+  public:
+    id_name_index();
+
+    explicit id_name_index(const std::unordered_map<std::string, uint32_t> &name_map);
+
+    /** Returns the name of the given ID, or nullptr if it is not defined.
+     *
+     *  If several names share an ID, the lexicographically smallest one is returned.
+     */
+    const std::string *find(uint32_t id) const noexcept;
+};
+
 class lp_lookup {
   private:
     purp_t default_purpose;
     purp_t pin_purpose;
     lay_map_t lay_map;
     purp_map_t purp_map;
+    id_name_index lay_names;
+    id_name_index purp_names;
 
   public:
     lp_lookup();
@@ -39,6 +73,14 @@ class lp_lookup {
     std::optional<lay_t> get_layer_id(const std::string &layer) const;
 
     std::optional<purp_t> get_purpose_id(const std::string &purpose) const;
+
+    /** Resolves the layer and purpose names of all the given layer/purpose pairs at once.
+     *
+     *  Undefined IDs resolve to nullptr.  The returned pointers are valid for the lifetime of
+     *  this object.
+     */
+    std::vector<std::pair<const std::string *, const std::string *>>
+    get_names(const std::vector<layer_t> &key_list) const;
 };
 
 } // namespace layout
@@ -1,9 +1,12 @@
 #ifndef CBAG_LAYOUT_ROUTING_GRID_FWD_H
 #define CBAG_LAYOUT_ROUTING_GRID_FWD_H
 
+#include <memory>
+
 #include <cbag/common/transformation_fwd.h>
 #include <cbag/common/typedefs.h>
 #include <cbag/enum/orient_2d.h>
+#include <cbag/layout/flip_parity_cache.h>
 
 namespace cbag {
 
@@ -20,6 +23,9 @@ class routing_grid {
     std::vector<track_info> info_list;
     level_t top_ignore_level = -1;
     level_t top_private_level = -1;
+    // flip parities depend on the track parities, so every modification of the grid replaces
+    // this cache instead of clearing it; copies made before the change keep the old one.
+    std::shared_ptr<flip_parity_cache> fp_cache;
     struct helper;
 
   public:
@@ -45,8 +51,15 @@ class routing_grid {
 
     level_t get_top_private_level() const noexcept;
 
-    flip_parity get_flip_parity_at(level_t bot_level, level_t top_level,
-                                   const transformation &xform) const;
+    /** Returns the flip parity of the given levels under the given transformation.
+     *
+     *  Parity offsets are reduced modulo twice the number of colors of each level, so all
+     *  transformations that give the same track coloring share one cached flip parity.
+     */
+    std::shared_ptr<const flip_parity> get_flip_parity_at(level_t bot_level, level_t top_level,
+                                                          const transformation &xform) const;
+
+    flip_parity_cache &get_flip_parity_cache() const noexcept;
 
     cnt_t get_htr_parity(level_t level, htr_t htr) const;
 
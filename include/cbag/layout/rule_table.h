@@ -0,0 +1,93 @@
+#ifndef CBAG_LAYOUT_RULE_TABLE_H
+#define CBAG_LAYOUT_RULE_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+
+#include <cbag/common/layer_t.h>
+#include <cbag/common/typedefs.h>
+#include <cbag/enum/space_type.h>
+#include <cbag/layout/len_info.h>
+
+namespace cbag {
+namespace layout {
+
+using sp_map_t =
+    std::unordered_map<layer_t, std::vector<std::pair<offset_t, offset_t>>, boost::hash<layer_t>>;
+using sp_map_grp_t = std::unordered_map<space_type, sp_map_t>;
+using len_map_t = std::unordered_map<layer_t, len_info, boost::hash<layer_t>>;
+using lp_list_t = std::vector<std::vector<layer_t>>;
+
+/** A compiled, read-only representation of the min space and min length rules.
+ *
+ *  Every layer/purpose pair with a rule is assigned a dense index, its position in a sorted
+ *  key array, so sparse layer IDs cost no extra memory.  Width-dependent rules of all layers
+ *  are stored in flat arrays of sorted width breakpoints, which are searched with a branchless
+ *  binary search.  The dense index of the first layer/purpose pair on each routing level is
+ *  precomputed, so level-based queries need no layer lookup at all.
+ */
+class rule_table {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  private:
+    static constexpr std::size_t num_sp_types = 3;
+
+    // width breakpoints and values of one rule type.
+    // rules of dense index idx are stored in [offsets[idx], offsets[idx + 1]).
+    template <typename T> struct width_table {
+        std::vector<uint32_t> offsets;
+        std::vector<offset_t> w_list;
+        std::vector<T> val_list;
+    };
+
+    // sorted layer/purpose pairs with rules; the dense index is the position in this list.
+    std::vector<layer_t> key_list;
+    // true for every space type defined in the technology.
+    std::array<bool, num_sp_types> sp_defined = {false, false, false};
+    std::vector<std::size_t> lev_idx_list;
+    std::array<width_table<offset_t>, num_sp_types> sp_tables;
+    width_table<max_len_data> len_w_table;
+    std::vector<uint32_t> len_md_offsets;
+    std::vector<max_len_data> len_md_list;
+
+    struct helper;
+
+  public:
+    rule_table();
+
+    rule_table(const sp_map_grp_t &sp_map_grp, const len_map_t &len_map, const lp_list_t &lp_list);
+
+    /** Returns the dense index of the given layer/purpose pair, or npos if it has no rules.
+     */
+    std::size_t get_index(layer_t key) const noexcept;
+
+    /** Returns the dense index of the first layer/purpose pair on the given level, or npos.
+     *
+     *  @param lev_idx the level index, relative to the bottom routing level.
+     */
+    std::size_t get_level_index(std::size_t lev_idx) const noexcept;
+
+    /** Returns the minimum space for the given dense index.  Returns 0 if idx is npos.
+     *
+     *  If same color space rules are not defined, SAME_COLOR queries use DIFF_COLOR rules.
+     *
+     *  @throws std::out_of_range if the technology defines no rules of the given space type.
+     */
+    offset_t get_min_space(std::size_t idx, offset_t width, space_type sp_type, bool even) const;
+
+    /** Returns the minimum length for the given dense index.  Returns 0 if idx is npos.
+     */
+    offset_t get_min_length(std::size_t idx, offset_t width, bool even) const noexcept;
+};
+
+} // namespace layout
+} // namespace cbag
+
+#endif
@@ -15,16 +15,12 @@
 #include <cbag/enum/space_type.h>
 #include <cbag/layout/len_info.h>
 #include <cbag/layout/lp_lookup.h>
+#include <cbag/layout/rule_table.h>
 #include <cbag/layout/via_lookup.h>
 
 namespace cbag {
 namespace layout {
 
-using sp_map_t =
-    std::unordered_map<layer_t, std::vector<std::pair<offset_t, offset_t>>, boost::hash<layer_t>>;
-using sp_map_grp_t = std::unordered_map<space_type, sp_map_t>;
-using len_map_t = std::unordered_map<layer_t, len_info, boost::hash<layer_t>>;
-using lp_list_t = std::vector<std::vector<layer_t>>;
 using level_map_t = std::unordered_map<layer_t, level_t, boost::hash<layer_t>>;
 
 class tech {
@@ -36,12 +32,12 @@ class tech {
     bool make_pin_obj = true;
     lp_lookup lp_map;
     via_lookup vlookup;
-    sp_map_grp_t sp_map_grp;
-    space_type sp_sc_type;
-    len_map_t len_map;
     level_t grid_bot_layer = 0;
     lp_list_t lp_list;
     level_map_t lev_map;
+    rule_table rules;
+
+    std::size_t get_rule_index(level_t level) const;
 
   public:
     tech(const std::string &tech_fname);
@@ -75,21 +71,58 @@ class tech {
 
     std::optional<purp_t> get_purpose_id(const std::string &purpose) const;
 
+    /** Resolves the layer and purpose names of all the given layer/purpose pairs at once.
+     *
+     *  Undefined IDs resolve to nullptr.
+     */
+    std::vector<std::pair<const std::string *, const std::string *>>
+    get_lay_purp_names(const std::vector<layer_t> &key_list) const;
+
     std::optional<level_t> get_level(layer_t key) const;
 
     const std::vector<layer_t> &get_lay_purp_list(level_t level) const;
 
+    /** Returns the number of layer/purpose pairs on the given routing level, or 0 if undefined.
+     */
+    std::size_t get_num_colors(level_t level) const noexcept;
+
     offset_t get_min_space(layer_t key, offset_t width, space_type sp_type, bool even) const;
 
+    /** Returns the minimum space of the first layer/purpose pair on the given routing level.
+     */
+    offset_t get_min_space(level_t level, offset_t width, space_type sp_type, bool even) const;
+
     offset_t get_min_length(layer_t key, offset_t width, bool even) const;
 
+    /** Returns the minimum length of the first layer/purpose pair on the given routing level.
+     */
+    offset_t get_min_length(level_t level, offset_t width, bool even) const;
+
+    /** Returns the compiled min space and min length rules.
+     *
+     *  Callers that look up several rules of the same layer can resolve the dense layer index
+     *  once with rule_table::get_index() and query the table directly.
+     */
+    const rule_table &get_rule_table() const noexcept;
+
+    via_def_t get_via_def(direction vdir, layer_t layer, layer_t adj_layer) const;
+
     const std::string &get_via_id(direction vdir, layer_t layer, layer_t adj_layer) const;
 
+    via_lay_purp_t get_via_layer_purpose(via_def_t vdef) const;
+
     via_lay_purp_t get_via_layer_purpose(const std::string &key) const;
 
+    via_param get_via_param(vector dim, via_def_t vdef, direction vdir, orient_2d ex_dir,
+                            orient_2d adj_ex_dir, bool extend) const;
+
     via_param get_via_param(vector dim, const std::string &via_id, direction vdir, orient_2d ex_dir,
                             orient_2d adj_ex_dir, bool extend) const;
 
+    /** Returns the memoization cache used by get_via_param(), for instrumentation.
+     */
+    const via_param_cache &get_via_param_cache() const noexcept;
+
     virtual em_specs_t get_metal_em_specs(const std::string &layer, const std::string &purpose,
                                           offset_t width, offset_t length, bool vertical,
                                           temp_t dc_temp, temp_t rms_dt) const;
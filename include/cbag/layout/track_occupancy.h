@@ -0,0 +1,78 @@
+#ifndef CBAG_LAYOUT_TRACK_OCCUPANCY_H
+#define CBAG_LAYOUT_TRACK_OCCUPANCY_H
+
+#include <array>
+#include <map>
+#include <vector>
+
+#include <cbag/common/box_t.h>
+#include <cbag/common/typedefs.h>
+#include <cbag/util/interval.h>
+
+namespace cbag {
+namespace layout {
+
+class routing_grid;
+
+/** Records which half-tracks of each routing level are blocked by shapes.
+ *
+ *  For every half-track that intersects a shape, the coordinate spans along the track direction
+ *  that are blocked are stored in a disjoint_intvs.  A shape blocks a half-track if the shape,
+ *  expanded by its spacing margins, overlaps a single-track wire centered on that half-track.
+ *
+ *  All queries take the coordinate span along the track direction as [coord[0], coord[1]).
+ */
+class track_occupancy {
+  private:
+    level_t bot_level = 0;
+    std::vector<std::map<htr_t, util::disjoint_intvs<>>> lev_list;
+
+    struct helper;
+
+  public:
+    track_occupancy();
+
+    track_occupancy(level_t bot_level, std::size_t num_levels);
+
+    bool operator==(const track_occupancy &rhs) const noexcept;
+
+    bool empty() const noexcept;
+
+    /** Marks all half-tracks on the given level as free.
+     */
+    void clear(level_t level);
+
+    /** Marks the half-tracks on the given level covered by box as blocked.
+     *
+     *  @param grid the routing grid.
+     *  @param level the routing level.
+     *  @param box the shape bounding box, already expanded by its spacing margins.
+     */
+    void add(const routing_grid &grid, level_t level, const box_t &box);
+
+    /** Returns true if no part of [coord[0], coord[1]) on the given half-track is blocked.
+     */
+    bool is_free(level_t level, htr_t htr, std::array<offset_t, 2> coord) const;
+
+    /** Returns the first free half-track starting at htr and advancing by step.
+     *
+     *  @param step the half-track increment.  Use a negative value to search downwards.
+     */
+    htr_t get_next_free(level_t level, htr_t htr, std::array<offset_t, 2> coord,
+                        htr_t step = 2) const;
+
+    /** Returns all free half-tracks in [start, stop), advancing by step.
+     */
+    std::vector<htr_t> get_free_tracks(level_t level, htr_t start, htr_t stop,
+                                       std::array<offset_t, 2> coord, htr_t step = 2) const;
+
+    /** Returns the blocked spans on the given half-track that overlap [coord[0], coord[1]).
+     */
+    std::vector<std::array<offset_t, 2>> get_blocked_spans(level_t level, htr_t htr,
+                                                           std::array<offset_t, 2> coord) const;
+};
+
+} // namespace layout
+} // namespace cbag
+
+#endif
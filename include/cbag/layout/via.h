@@ -4,6 +4,7 @@
 #include <string>
 
 #include <cbag/common/transformation.h>
+#include <cbag/layout/via_def.h>
 #include <cbag/layout/via_param.h>
 
 namespace cbag {
@@ -14,7 +15,7 @@ namespace layout {
 
 class via {
   private:
-    std::string via_id;
+    via_def_t vdef = invalid_via_def;
     via_param params;
     struct helper;
 
@@ -24,7 +25,11 @@ class via {
   public:
     via();
 
-    via(cbag::transformation xform, std::string via_id, via_param params);
+    via(cbag::transformation xform, via_def_t vdef, via_param params);
+
+    via(cbag::transformation xform, const std::string &via_id, via_param params);
+
+    via_def_t get_via_def() const noexcept;
 
     const std::string &get_via_id() const;
 
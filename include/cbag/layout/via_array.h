@@ -0,0 +1,41 @@
+#ifndef CBAG_LAYOUT_VIA_ARRAY_H
+#define CBAG_LAYOUT_VIA_ARRAY_H
+
+#include <cbag/layout/via.h>
+
+namespace cbag {
+namespace layout {
+
+/** An nx by ny array of vias with pitch (spx, spy).
+ *
+ *  Element (ix, iy) is base moved by (ix * spx, iy * spy).
+ */
+struct via_array {
+  public:
+    via base;
+    cnt_t nx = 1;
+    cnt_t ny = 1;
+    offset_t spx = 0;
+    offset_t spy = 0;
+
+    via_array();
+
+    via_array(via base, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy);
+
+    bool operator==(const via_array &rhs) const noexcept;
+
+    via get_via(cnt_t ix, cnt_t iy) const;
+
+    template <typename F> void for_each(F fun) const {
+        for (cnt_t ix = 0; ix < nx; ++ix) {
+            for (cnt_t iy = 0; iy < ny; ++iy) {
+                fun(get_via(ix, iy));
+            }
+        }
+    }
+};
+
+} // namespace layout
+} // namespace cbag
+
+#endif
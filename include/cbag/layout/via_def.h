@@ -0,0 +1,41 @@
+#ifndef CBAG_LAYOUT_VIA_DEF_H
+#define CBAG_LAYOUT_VIA_DEF_H
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+
+namespace cbag {
+namespace layout {
+
+/** A via definition handle.
+ *
+ *  Via IDs are interned into a process-wide table of small integer handles, so vias store a
+ *  handle instead of a string, and technology via definitions are stored in vectors indexed by
+ *  handle.  Handles are assigned in interning order, so they must not be persisted.
+ */
+using via_def_t = uint32_t;
+
+/** The handle of a via with no via definition, such as a default-constructed via.
+ *
+ *  It is never returned by intern_via_id(), and all lookups reject it.
+ */
+constexpr via_def_t invalid_via_def = std::numeric_limits<via_def_t>::max();
+
+/** Returns the handle of the given via ID, interning it if needed.  Thread-safe.
+ */
+via_def_t intern_via_id(const std::string &via_id);
+
+/** Returns the handle of the given via ID, or an empty optional if it was never interned.
+ */
+std::optional<via_def_t> find_via_def(const std::string &via_id);
+
+/** Returns the via ID of the given handle.  The reference is valid for the program lifetime.
+ */
+const std::string &get_via_id_str(via_def_t vdef);
+
+} // namespace layout
+} // namespace cbag
+
+#endif
@@ -3,6 +3,8 @@
 #define CBAG_COMMON_VIA_LOOKUP_H
 
 #include <array>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include <boost/container_hash/hash.hpp>
@@ -12,8 +14,11 @@
 #include <cbag/common/typedefs.h>
 #include <cbag/enum/direction.h>
 #include <cbag/enum/orient_2d.h>
+#include <cbag/layout/via_def.h>
 #include <cbag/layout/via_info.h>
 #include <cbag/layout/via_param.h>
+#include <cbag/layout/via_param_cache.h>
+#include <cbag/layout/via_table.h>
 
 namespace YAML {
 class Node;
@@ -27,26 +32,56 @@ class lp_lookup;
 using via_lay_purp_t = std::tuple<layer_t, layer_t, layer_t>;
 using vlp_map_t = std::unordered_map<std::string, via_lay_purp_t>;
 using vlayers_t = std::array<layer_t, 2>;
-using vid_map_t = std::unordered_map<vlayers_t, std::string, boost::hash<vlayers_t>>;
+using vid_map_t = std::unordered_map<vlayers_t, via_def_t, boost::hash<vlayers_t>>;
 using vinfo_map_t = std::unordered_map<std::string, std::vector<via_info>>;
 
+/** The technology data of a single via definition.
+ */
+struct via_def_info {
+    std::optional<via_lay_purp_t> lay_purp;
+    std::optional<std::vector<via_info>> info_list;
+    std::optional<via_table> table;
+};
+
+/** Computes the optimal via solution among the given via_info alternatives.
+ */
+via_param compute_via_param(const std::vector<via_info> &vinfo_list, vector dim, direction vdir,
+                            orient_2d ex_dir, orient_2d adj_ex_dir, bool extend);
+
 class via_lookup {
   private:
-    vlp_map_t lp_map;
+    // indexed by via definition handle
+    std::vector<via_def_info> def_list;
     vid_map_t id_map;
-    vinfo_map_t info_map;
+    std::unique_ptr<via_param_cache> cache = std::make_unique<via_param_cache>();
+    struct helper;
 
   public:
     via_lookup();
 
     via_lookup(const YAML::Node &parent, const lp_lookup &lp);
 
+    via_lay_purp_t get_via_layer_purpose(via_def_t vdef) const;
+
     via_lay_purp_t get_via_layer_purpose(const std::string &key) const;
 
+    via_def_t get_via_def(direction vdir, layer_t layer, layer_t adj_layer) const;
+
     const std::string &get_via_id(direction vdir, layer_t layer, layer_t adj_layer) const;
 
+    via_param get_via_param(vector dim, via_def_t vdef, direction vdir, orient_2d ex_dir,
+                            orient_2d adj_ex_dir, bool extend) const;
+
     via_param get_via_param(vector dim, const std::string &via_id, direction vdir, orient_2d ex_dir,
                             orient_2d adj_ex_dir, bool extend) const;
+
+    const via_param_cache &get_via_param_cache() const noexcept;
+
+    /** Returns the precomputed via solution table for the given via ID, or nullptr.
+     */
+    const via_table *get_via_table(via_def_t vdef) const;
+
+    const via_table *get_via_table(const std::string &via_id) const;
 };
 
 } // namespace layout
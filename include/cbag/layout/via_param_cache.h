@@ -0,0 +1,38 @@
+#ifndef CBAG_LAYOUT_VIA_PARAM_CACHE_H
+#define CBAG_LAYOUT_VIA_PARAM_CACHE_H
+
+#include <cbag/common/vector.h>
+#include <cbag/enum/direction.h>
+#include <cbag/enum/orient_2d.h>
+#include <cbag/layout/via_def.h>
+#include <cbag/layout/via_param.h>
+#include <cbag/util/memo_cache.h>
+
+namespace cbag {
+namespace layout {
+
+/** The arguments of a via_lookup::get_via_param() query.
+ */
+struct via_query {
+    vector dim = {0, 0};
+    via_def_t vdef = 0;
+    direction vdir = direction::LOWER;
+    orient_2d ex_dir = orient_2d::HORIZONTAL;
+    orient_2d adj_ex_dir = orient_2d::HORIZONTAL;
+    bool extend = true;
+
+    bool operator==(const via_query &rhs) const noexcept;
+};
+
+struct via_query_hash {
+    std::size_t operator()(const via_query &v) const;
+};
+
+/** A thread-safe memoization cache of via_param solutions.
+ */
+using via_param_cache = util::memo_cache<via_query, via_param, via_query_hash>;
+
+} // namespace layout
+} // namespace cbag
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef CBAG_LAYOUT_VIA_TABLE_H
+#define CBAG_LAYOUT_VIA_TABLE_H
+
+#include <array>
+#include <vector>
+
+#include <cbag/common/typedefs.h>
+#include <cbag/common/vector.h>
+#include <cbag/enum/direction.h>
+#include <cbag/enum/orient_2d.h>
+#include <cbag/layout/via_param.h>
+
+namespace cbag {
+namespace layout {
+
+class via_info;
+
+/** A precomputed table of via solutions for a single via ID.
+ *
+ *  The table stores the optimal via_param for every combination of the given box widths and
+ *  heights, for both via directions, all extension directions, and both values of the extend
+ *  flag.
+ */
+class via_table {
+  private:
+    std::array<std::vector<offset_t>, 2> dim_list;
+    std::vector<via_param> table;
+
+    struct helper;
+
+  public:
+    via_table();
+
+    via_table(std::array<std::vector<offset_t>, 2> &&dims, const std::vector<via_info> &vinfo_list);
+
+    std::size_t size() const noexcept;
+
+    /** Returns the precomputed via solution, or nullptr if dim is not in the table.
+     */
+    const via_param *find(vector dim, direction vdir, orient_2d ex_dir, orient_2d adj_ex_dir,
+                          bool extend) const;
+};
+
+} // namespace layout
+} // namespace cbag
+
+#endif
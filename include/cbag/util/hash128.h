@@ -0,0 +1,90 @@
+#ifndef CBAG_UTIL_HASH128_H
+#define CBAG_UTIL_HASH128_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace cbag {
+namespace util {
+
+/** A 128-bit hash value.
+ *
+ *  operator+= combines hash values commutatively, so hashes of unordered collections can be
+ *  maintained incrementally.
+ */
+struct hash128 {
+  public:
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    bool operator==(const hash128 &rhs) const noexcept { return lo == rhs.lo && hi == rhs.hi; }
+    bool operator!=(const hash128 &rhs) const noexcept { return !(*this == rhs); }
+
+    hash128 &operator+=(const hash128 &rhs) noexcept {
+        lo += rhs.lo;
+        hi += rhs.hi;
+        return *this;
+    }
+
+    std::size_t get_hash() const noexcept {
+        return static_cast<std::size_t>(lo ^ (hi * 0x9e3779b97f4a7c15ULL));
+    }
+};
+
+/** A streaming hasher that produces a hash128 from a sequence of values.
+ */
+class hasher128 {
+  private:
+    uint64_t lo = 0x243f6a8885a308d3ULL;
+    uint64_t hi = 0x13198a2e03707344ULL;
+    uint64_t cnt = 0;
+
+    // splitmix64 finalizer
+    static constexpr uint64_t mix(uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+  public:
+    template <typename T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, int> = 0>
+    hasher128 &add(T val) noexcept {
+        auto v = static_cast<uint64_t>(val);
+        lo = mix(lo ^ v);
+        hi = mix(hi + ((v << 32) | (v >> 32)));
+        ++cnt;
+        return *this;
+    }
+
+    hasher128 &add(double val) noexcept {
+        uint64_t v;
+        std::memcpy(&v, &val, sizeof(v));
+        return add(v);
+    }
+
+    hasher128 &add(const std::string &val) noexcept {
+        add(val.size());
+        auto n = val.size();
+        std::size_t idx = 0;
+        for (; idx + 8 <= n; idx += 8) {
+            uint64_t v;
+            std::memcpy(&v, val.data() + idx, 8);
+            add(v);
+        }
+        if (idx < n) {
+            uint64_t v = 0;
+            std::memcpy(&v, val.data() + idx, n - idx);
+            add(v);
+        }
+        return *this;
+    }
+
+    hash128 get() const noexcept { return {mix(lo ^ cnt), mix(hi + cnt)}; }
+};
+
+} // namespace util
+} // namespace cbag
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef CBAG_UTIL_INDEXED_HEAP_H
+#define CBAG_UTIL_INDEXED_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cbag {
+namespace util {
+
+/** A binary min-heap of integer keys in [0, capacity) that supports changing priorities.
+ *
+ *  The heap position of every key is tracked, so the priority of a key already in the heap can
+ *  be updated in logarithmic time instead of pushing a duplicate entry.  Keys with equal
+ *  priorities are ordered by key value, so the pop order is fully deterministic.
+ */
+template <class P, class Compare = std::less<P>> class indexed_heap {
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  private:
+    std::vector<std::size_t> heap;
+    std::vector<std::size_t> pos;
+    std::vector<P> prio;
+    Compare comp;
+
+    bool less(std::size_t lhs, std::size_t rhs) const {
+        if (comp(prio[lhs], prio[rhs]))
+            return true;
+        if (comp(prio[rhs], prio[lhs]))
+            return false;
+        return lhs < rhs;
+    }
+
+    void place(std::size_t idx, std::size_t key) {
+        heap[idx] = key;
+        pos[key] = idx;
+    }
+
+    void sift_up(std::size_t idx) {
+        auto key = heap[idx];
+        while (idx > 0) {
+            auto parent = (idx - 1) / 2;
+            if (!less(key, heap[parent]))
+                break;
+            place(idx, heap[parent]);
+            idx = parent;
+        }
+        place(idx, key);
+    }
+
+    void sift_down(std::size_t idx) {
+        auto key = heap[idx];
+        auto n = heap.size();
+        for (auto child = 2 * idx + 1; child < n; child = 2 * idx + 1) {
+            if (child + 1 < n && less(heap[child + 1], heap[child]))
+                ++child;
+            if (!less(heap[child], key))
+                break;
+            place(idx, heap[child]);
+            idx = child;
+        }
+        place(idx, key);
+    }
+
+  public:
+    indexed_heap() = default;
+
+    explicit indexed_heap(std::size_t capacity) : pos(capacity, npos), prio(capacity) {}
+
+    bool empty() const noexcept { return heap.empty(); }
+
+    std::size_t size() const noexcept { return heap.size(); }
+
+    std::size_t capacity() const noexcept { return pos.size(); }
+
+    bool contains(std::size_t key) const { return key < pos.size() && pos[key] != npos; }
+
+    /** Removes all keys and sets the key capacity.
+     */
+    void reset(std::size_t capacity) {
+        for (auto key : heap) {
+            pos[key] = npos;
+        }
+        heap.clear();
+        pos.resize(capacity, npos);
+        prio.resize(capacity);
+    }
+
+    /** Inserts the given key, or changes its priority if it is already in the heap.
+     */
+    void push(std::size_t key, P val) {
+        if (key >= pos.size())
+            throw std::out_of_range("indexed_heap key " + std::to_string(key) +
+                                    " out of range.");
+        auto idx = pos[key];
+        prio[key] = std::move(val);
+        if (idx == npos) {
+            heap.push_back(key);
+            sift_up(heap.size() - 1);
+        } else {
+            sift_up(idx);
+            sift_down(pos[key]);
+        }
+    }
+
+    std::size_t top() const { return heap.front(); }
+
+    const P &top_priority() const { return prio[heap.front()]; }
+
+    const P &priority(std::size_t key) const { return prio[key]; }
+
+    void pop() {
+        pos[heap.front()] = npos;
+        auto last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            sift_down(0);
+        }
+    }
+};
+
+} // namespace util
+} // namespace cbag
+
+#endif
@@ -11,6 +11,12 @@ namespace util {
 // ceiling division
 inline constexpr int ceil(int x, unsigned int y) { return x / y + (x % y > 0); }
 
+// floor division, y must be positive
+inline constexpr int64_t floor_div(int64_t x, int64_t y) { return x / y - (x % y < 0); }
+
+// ceiling division, y must be positive
+inline constexpr int64_t ceil_div(int64_t x, int64_t y) { return x / y + (x % y > 0); }
+
 // only works on arithmetic right shift architectures
 inline constexpr int floor2(int a) { return a >> 1; }
 
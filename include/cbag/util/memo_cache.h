@@ -0,0 +1,74 @@
+#ifndef CBAG_UTIL_MEMO_CACHE_H
+#define CBAG_UTIL_MEMO_CACHE_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace cbag {
+namespace util {
+
+/** A thread-safe memoization cache with hit/miss counters.
+ *
+ *  If max_size is nonzero, the cache is cleared when it reaches that size, which bounds its
+ *  memory use.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>> class memo_cache {
+  private:
+    mutable std::shared_mutex lock;
+    std::unordered_map<Key, Value, Hash> table;
+    std::size_t max_size = 0;
+    mutable std::atomic<std::size_t> num_hits = 0;
+    mutable std::atomic<std::size_t> num_misses = 0;
+
+  public:
+    explicit memo_cache(std::size_t max_size = 0) : max_size(max_size) {}
+
+    /** Returns the cached value, or an empty optional.  Updates the hit/miss counters.
+     */
+    std::optional<Value> find(const Key &key) const {
+        std::shared_lock guard(lock);
+        auto iter = table.find(key);
+        if (iter == table.end()) {
+            ++num_misses;
+            return {};
+        }
+        ++num_hits;
+        return iter->second;
+    }
+
+    /** Inserts the given value and returns the cached value.
+     *
+     *  If another thread inserted the same key first, the existing value is returned.
+     */
+    Value insert(Key key, Value val) {
+        std::unique_lock guard(lock);
+        if (max_size > 0 && table.size() >= max_size)
+            table.clear();
+        return table.emplace(std::move(key), std::move(val)).first->second;
+    }
+
+    void clear() {
+        std::unique_lock guard(lock);
+        table.clear();
+        num_hits = 0;
+        num_misses = 0;
+    }
+
+    std::size_t size() const {
+        std::shared_lock guard(lock);
+        return table.size();
+    }
+
+    std::size_t get_num_hits() const noexcept { return num_hits; }
+
+    std::size_t get_num_misses() const noexcept { return num_misses; }
+};
+
+} // namespace util
+} // namespace cbag
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef CBAG_UTIL_PARALLEL_H
+#define CBAG_UTIL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cbag {
+namespace util {
+
+/** Returns the number of worker threads to use.
+ *
+ *  @param num_workers the requested number of workers.  0 means use all hardware threads.
+ *  @param num_tasks the number of tasks; no more workers than tasks are used.
+ */
+inline std::size_t get_num_workers(std::size_t num_workers, std::size_t num_tasks) {
+    if (num_workers == 0) {
+        num_workers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    return std::max(std::min(num_workers, num_tasks), static_cast<std::size_t>(1));
+}
+
+/** A process-wide pool of persistent worker threads.
+ *
+ *  Threads are started on demand and live until the program exits, so repeated parallel
+ *  sections do not pay for thread creation.
+ */
+class thread_pool {
+  private:
+    std::mutex lock;
+    std::condition_variable has_work;
+    std::deque<std::function<void()>> queue;
+    std::vector<std::thread> workers;
+    bool stop = false;
+
+    thread_pool() = default;
+
+  public:
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool();
+
+    static thread_pool &get_instance();
+
+    /** Returns true if the calling thread is a worker of the pool.
+     */
+    static bool in_worker() noexcept;
+
+    std::size_t size();
+
+    /** Starts new threads until the pool has at least the given number of threads.
+     */
+    void reserve(std::size_t num_threads);
+
+    void submit(std::function<void()> &&task);
+
+  private:
+    void run_worker();
+};
+
+/** Calls fun(idx) for every idx in [0, num_tasks) using the shared thread pool.
+ *
+ *  Tasks are handed out dynamically, so the order in which they run is unspecified.  If any
+ *  task throws, remaining tasks are skipped and the first exception is rethrown in the
+ *  calling thread.  Calls made from a pool thread run serially, so nested calls cannot
+ *  deadlock the pool.
+ *
+ *  @param num_tasks number of tasks.
+ *  @param num_workers the number of workers.  0 means use all hardware threads.
+ *  @param fun the task function.
+ */
+template <typename F> void parallel_for(std::size_t num_tasks, std::size_t num_workers, F &&fun) {
+    num_workers = get_num_workers(num_workers, num_tasks);
+    if (num_workers == 1 || thread_pool::in_worker()) {
+        for (std::size_t idx = 0; idx < num_tasks; ++idx) {
+            fun(idx);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr err;
+    std::mutex err_lock;
+    auto work = [&]() {
+        for (auto idx = next++; idx < num_tasks; idx = next++) {
+            try {
+                fun(idx);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(err_lock);
+                if (!err)
+                    err = std::current_exception();
+                next = num_tasks;
+            }
+        }
+    };
+
+    // the calling thread is one of the workers
+    auto num_helpers = num_workers - 1;
+    auto num_running = num_helpers;
+    std::mutex done_lock;
+    std::condition_variable done_cv;
+    auto &pool = thread_pool::get_instance();
+    pool.reserve(num_helpers);
+    for (std::size_t idx = 0; idx < num_helpers; ++idx) {
+        pool.submit([&]() {
+            work();
+            std::lock_guard<std::mutex> guard(done_lock);
+            if (--num_running == 0)
+                done_cv.notify_one();
+        });
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> guard(done_lock);
+        done_cv.wait(guard, [&num_running]() { return num_running == 0; });
+    }
+    if (err)
+        std::rethrow_exception(err);
+}
+
+} // namespace util
+} // namespace cbag
+
+#endif
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstring>
+
+#include <cbag/gdsii/byte_swap.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define CBAG_GDSII_SIMD_X86 1
+#else
+#define CBAG_GDSII_SIMD_X86 0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define CBAG_GDSII_BIG_ENDIAN 1
+#else
+#define CBAG_GDSII_BIG_ENDIAN 0
+#endif
+
+namespace cbag {
+namespace gdsii {
+
+namespace {
+
+// the kernels reverse the bytes of every unit_size-byte value, which converts between
+// big-endian and little-endian in both directions.
+
+template <std::size_t unit_size>
+void swap_scalar(const char *src, char *dst, std::size_t num) noexcept {
+    for (std::size_t idx = 0; idx < num; ++idx, src += unit_size, dst += unit_size) {
+        for (std::size_t bidx = 0; bidx < unit_size; ++bidx) {
+            dst[bidx] = src[unit_size - 1 - bidx];
+        }
+    }
+}
+
+#if CBAG_GDSII_SIMD_X86
+
+// SSE2 has no byte shuffle, so swap bytes within 16-bit words, then reorder the words.
+template <std::size_t unit_size>
+__attribute__((target("sse2"))) void swap_sse2(const char *src, char *dst,
+                                               std::size_t num) noexcept {
+    constexpr std::size_t num_vec = 16 / unit_size;
+    std::size_t idx = 0;
+    for (; idx + num_vec <= num; idx += num_vec) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + idx * unit_size));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        if constexpr (unit_size == 4) {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        } else {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + idx * unit_size), v);
+    }
+    swap_scalar<unit_size>(src + idx * unit_size, dst + idx * unit_size, num - idx);
+}
+
+template <std::size_t unit_size>
+__attribute__((target("avx2"))) void swap_avx2(const char *src, char *dst,
+                                               std::size_t num) noexcept {
+    constexpr std::size_t num_vec = 32 / unit_size;
+    // the byte shuffle works within each 128-bit lane, so the mask repeats.
+    const auto mask = (unit_size == 4)
+                          ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                             3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+                          : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    std::size_t idx = 0;
+    for (; idx + 2 * num_vec <= num; idx += 2 * num_vec) {
+        auto ptr = src + idx * unit_size;
+        auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr + 32));
+        auto out = dst + idx * unit_size;
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_shuffle_epi8(v0, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32), _mm256_shuffle_epi8(v1, mask));
+    }
+    for (; idx + num_vec <= num; idx += num_vec) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + idx * unit_size));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + idx * unit_size),
+                            _mm256_shuffle_epi8(v, mask));
+    }
+    swap_scalar<unit_size>(src + idx * unit_size, dst + idx * unit_size, num - idx);
+}
+
+#endif
+
+simd_level detect_simd_level() noexcept {
+#if CBAG_GDSII_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return simd_level::SSE2;
+#endif
+    return simd_level::SCALAR;
+}
+
+template <std::size_t unit_size>
+void swap_array(const char *src, char *dst, std::size_t num, simd_level level) noexcept {
+#if CBAG_GDSII_BIG_ENDIAN
+    std::memcpy(dst, src, num * unit_size);
+#else
+    switch (std::min(level, get_simd_level())) {
+#if CBAG_GDSII_SIMD_X86
+    case simd_level::AVX2:
+        swap_avx2<unit_size>(src, dst, num);
+        break;
+    case simd_level::SSE2:
+        swap_sse2<unit_size>(src, dst, num);
+        break;
+#endif
+    default:
+        swap_scalar<unit_size>(src, dst, num);
+    }
+#endif
+}
+
+} // namespace
+
+simd_level get_simd_level() noexcept {
+    static const auto ans = detect_simd_level();
+    return ans;
+}
+
+void decode_int32_array(const char *src, int32_t *dst, std::size_t num, simd_level level) {
+    swap_array<4>(src, reinterpret_cast<char *>(dst), num, level);
+}
+
+void encode_int32_array(const int32_t *src, char *dst, std::size_t num, simd_level level) {
+    swap_array<4>(reinterpret_cast<const char *>(src), dst, num, level);
+}
+
+void decode_uint64_array(const char *src, uint64_t *dst, std::size_t num, simd_level level) {
+    swap_array<8>(src, reinterpret_cast<char *>(dst), num, level);
+}
+
+void encode_uint64_array(const uint64_t *src, char *dst, std::size_t num, simd_level level) {
+    swap_array<8>(reinterpret_cast<const char *>(src), dst, num, level);
+}
+
+} // namespace gdsii
+} // namespace cbag
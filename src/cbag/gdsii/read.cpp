@@ -1,6 +1,9 @@
 #include <fmt/core.h>
 
+#include <spdlog/sinks/dist_sink.h>
+
 #include <cbag/util/overload.h>
+#include <cbag/util/parallel.h>
 
 #include <cbag/gdsii/parse_map.h>
 #include <cbag/gdsii/read.h>
@@ -67,14 +70,19 @@ layer_t gds_rlookup::get_layer_t(gds_layer_t key) const {
     return iter->second;
 }
 
-std::string read_gds_start(spdlog::logger &logger, std::istream &stream) {
-    read_header(logger, stream);
-    read_lib_begin(logger, stream);
-    auto ans = read_lib_name(logger, stream);
-    read_units(logger, stream);
+std::string read_gds_start(spdlog::logger &logger, record_cursor &cursor) {
+    read_header(logger, cursor);
+    read_lib_begin(logger, cursor);
+    auto ans = read_lib_name(logger, cursor);
+    read_units(logger, cursor);
     return ans;
 }
 
+std::string read_gds_start(spdlog::logger &logger, std::istream &stream) {
+    record_cursor cursor(read_records_until(stream, record_type::UNITS));
+    return read_gds_start(logger, cursor);
+}
+
 void add_object(spdlog::logger &logger, layout::cellview &ans, gds_layer_t &&gds_key,
                 layout::polygon &&poly, const gds_rlookup &rmap) {
     auto map_val = rmap.get_mapping(gds_key);
@@ -96,10 +104,10 @@ void add_object(spdlog::logger &logger, layout::cellview &ans, gds_layer_t &&gds
 }
 
 std::tuple<std::string, std::unique_ptr<layout::cellview>>
-read_lay_cellview(spdlog::logger &logger, std::istream &stream, const std::string &lib_name,
+read_lay_cellview(spdlog::logger &logger, record_cursor &cursor, const std::string &lib_name,
                   const layout::routing_grid &g, const gds_rlookup &rmap,
                   const std::unordered_map<std::string, layout::cellview *> &master_map) {
-    auto cell_name = read_struct_name(logger, stream);
+    auto cell_name = read_struct_name(logger, cursor);
 
     logger.info("GDS cellview name: " + cell_name);
 
@@ -107,32 +115,32 @@ read_lay_cellview(spdlog::logger &logger, std::istream &stream, const std::strin
     auto resolution = g.get_tech()->get_resolution();
     auto inst_cnt = static_cast<std::size_t>(0);
     while (true) {
-        auto [rtype, rsize] = read_record_header(stream);
+        auto rtype = cursor.next().type;
         switch (rtype) {
         case record_type::TEXT: {
             logger.info("Reading layout text.");
-            auto [gds_key, xform, text, text_h_dbl] = read_text(logger, stream);
+            auto [gds_key, xform, text, text_h_dbl] = read_text(logger, cursor);
             auto text_h = static_cast<offset_t>(text_h_dbl / resolution);
             cv_ptr->add_label(rmap.get_layer_t(gds_key), std::move(xform), std::move(text), text_h);
             break;
         }
         case record_type::SREF:
             logger.info("Reading layout instance.");
-            cv_ptr->add_object(read_instance(logger, stream, inst_cnt, master_map));
+            cv_ptr->add_object(read_instance(logger, cursor, inst_cnt, master_map));
             break;
         case record_type::AREF:
             logger.info("Reading layout array instance.");
-            cv_ptr->add_object(read_arr_instance(logger, stream, inst_cnt, master_map));
+            cv_ptr->add_object(read_arr_instance(logger, cursor, inst_cnt, master_map));
             break;
         case record_type::BOX: {
             logger.info("Reading layout box.");
-            auto [gds_key, poly] = read_box(logger, stream);
+            auto [gds_key, poly] = read_box(logger, cursor);
             add_object(logger, *cv_ptr, std::move(gds_key), std::move(poly), rmap);
             break;
         }
         case record_type::BOUNDARY: {
             logger.info("Reading layout boundary.");
-            auto [gds_key, poly] = read_boundary(logger, stream);
+            auto [gds_key, poly] = read_boundary(logger, cursor);
             add_object(logger, *cv_ptr, std::move(gds_key), std::move(poly), rmap);
             break;
         }
@@ -146,5 +154,50 @@ read_lay_cellview(spdlog::logger &logger, std::istream &stream, const std::strin
     }
 }
 
+std::tuple<std::string, std::unique_ptr<layout::cellview>>
+read_lay_cellview(spdlog::logger &logger, std::istream &stream, const std::string &lib_name,
+                  const layout::routing_grid &g, const gds_rlookup &rmap,
+                  const std::unordered_map<std::string, layout::cellview *> &master_map) {
+    record_cursor cursor(read_records_until(stream, record_type::ENDSTR));
+    return read_lay_cellview(logger, cursor, lib_name, g, rmap, master_map);
+}
+
+std::vector<std::unique_ptr<layout::cellview>>
+read_lay_cellviews(spdlog::logger &logger, const record_cursor &cursor, const struct_index &index,
+                   const std::vector<std::vector<std::size_t>> &waves,
+                   const layout::routing_grid &g, const gds_rlookup &rmap,
+                   std::size_t num_workers) {
+    // the sinks of logger may not be thread-safe, so workers log through a locking sink.
+    auto sink = std::make_shared<spdlog::sinks::dist_sink_mt>(logger.sinks());
+    spdlog::logger worker_logger(logger.name(), sink);
+    worker_logger.set_level(logger.level());
+
+    std::vector<std::unique_ptr<layout::cellview>> ans(index.size());
+    std::unordered_map<std::string, layout::cellview *> cv_map;
+    auto &lib_name = index.get_lib_name();
+    auto bot_lev = g.get_bot_level();
+    auto top_lev = g.get_top_level();
+    for (const auto &wave : waves) {
+        util::parallel_for(wave.size(), num_workers, [&](std::size_t widx) {
+            auto &info = index[wave[widx]];
+            auto cur = cursor.slice(info.start, info.stop);
+            auto [cell_name, cv_ptr] =
+                read_lay_cellview(worker_logger, cur, lib_name, g, rmap, cv_map);
+            // build the geometry indices now, so parents in later waves only read them.
+            for (auto lev = bot_lev; lev <= top_lev; ++lev) {
+                cv_ptr->get_geo_index(lev).commit();
+            }
+            ans[wave[widx]] = std::move(cv_ptr);
+        });
+
+        // like the file order reader, duplicate names refer to the first structure.
+        for (auto idx : wave) {
+            if (index.find(index[idx].name) == idx)
+                cv_map.emplace(index[idx].name, ans[idx].get());
+        }
+    }
+    return ans;
+}
+
 } // namespace gdsii
 } // namespace cbag
@@ -6,6 +6,7 @@
 #include <cbag/common/transformation_util.h>
 #include <cbag/gdsii/math.h>
 #include <cbag/gdsii/read_util.h>
+#include <cbag/gdsii/record_cursor.h>
 #include <cbag/gdsii/typedefs.h>
 #include <cbag/layout/cellview.h>
 #include <cbag/layout/instance.h>
@@ -22,102 +23,56 @@ std::tuple<record_type, std::size_t> read_record_header(std::istream &stream) {
     return {static_cast<record_type>(record_val), size};
 }
 
-std::tuple<record_type, std::size_t> peek_record_header(std::istream &stream) {
-    auto ans = read_record_header(stream);
-    stream.seekg(-4, std::ios::cur);
-    return ans;
-}
-
 std::tuple<record_type, std::size_t> print_record_header(std::istream &stream) {
     auto ans = read_record_header(stream);
     std::cout << to_string(std::get<0>(ans)) << std::endl;
     return ans;
 }
 
-template <record_type R, std::size_t unit_size = 1, std::size_t num_data = 0>
-std::size_t check_record_header(std::istream &stream) {
-    auto [actual, size] = read_record_header(stream);
-    if (actual != R)
-        throw std::runtime_error(fmt::format("got gds record {:#x}, expected {:#x}",
-                                             static_cast<int>(actual), static_cast<int>(R)));
-
-    auto ans = size / unit_size;
-    auto mod = size % unit_size;
-    if (mod != 0)
-        throw std::runtime_error(
-            fmt::format("gds record size {} not divisible by unit size {}", size, unit_size));
-
-    if (num_data != 0 && ans != num_data) {
-        throw std::runtime_error(
-            fmt::format("gds record has {} elements, expected {}", ans, num_data));
-    }
-    return ans;
+template <record_type R> uint16_t read_int(spdlog::logger &logger, record_cursor &cursor) {
+    return cursor.next(R, sizeof(uint16_t), 1).get_uint16();
 }
 
-template <record_type R, std::size_t unit_size = 1, std::size_t num_data = 0>
-void read_skip(std::istream &stream) {
-    auto num = check_record_header<R, unit_size, num_data>(stream);
-    stream.ignore(num * unit_size);
+std::tuple<uint16_t, uint16_t> read_col_row(spdlog::logger &logger, record_cursor &cursor) {
+    auto rec = cursor.next(record_type::COLROW, sizeof(uint16_t), 2);
+    return {rec.get_uint16(0), rec.get_uint16(1)};
 }
 
-template <record_type R> uint16_t read_int(spdlog::logger &logger, std::istream &stream) {
-    check_record_header<R, sizeof(uint16_t), 1>(stream);
-    return read_bytes<uint16_t>(stream);
+template <record_type R> double read_double(spdlog::logger &logger, record_cursor &cursor) {
+    return gds_to_double(cursor.next(R, sizeof(uint64_t), 1).get_uint64());
 }
 
-std::tuple<uint16_t, uint16_t> read_col_row(spdlog::logger &logger, std::istream &stream) {
-    check_record_header<record_type::COLROW, sizeof(uint16_t), 2>(stream);
-    auto nx = read_bytes<uint16_t>(stream);
-    auto ny = read_bytes<uint16_t>(stream);
-    return {nx, ny};
+template <record_type R> std::string read_name(spdlog::logger &logger, record_cursor &cursor) {
+    return std::string(cursor.next(R).get_string());
 }
 
-template <record_type R> double read_double(spdlog::logger &logger, std::istream &stream) {
-    check_record_header<R, sizeof(uint64_t), 1>(stream);
-    return gds_to_double(read_bytes<uint64_t>(stream));
+void read_header(spdlog::logger &logger, record_cursor &cursor) {
+    cursor.next(record_type::HEADER, sizeof(uint16_t), 1);
 }
 
-template <record_type R> std::string read_name(spdlog::logger &logger, std::istream &stream) {
-    std::string ans;
-    auto num = check_record_header<R, sizeof(char)>(stream);
-    ans.reserve(num);
-    for (decltype(num) idx = 0; idx < num; ++idx) {
-        ans.push_back(read_bytes<char>(stream));
-    }
-    return ans;
+void read_lib_begin(spdlog::logger &logger, record_cursor &cursor) {
+    cursor.next(record_type::BGNLIB, sizeof(tval_t), 12);
 }
 
-template <record_type R> void read_grp_begin(spdlog::logger &logger, std::istream &stream) {
-    read_skip<R, sizeof(tval_t), 12>(stream);
+std::string read_lib_name(spdlog::logger &logger, record_cursor &cursor) {
+    return read_name<record_type::LIBNAME>(logger, cursor);
 }
 
-void read_header(spdlog::logger &logger, std::istream &stream) {
-    read_skip<record_type::HEADER, sizeof(uint16_t), 1>(stream);
+void read_units(spdlog::logger &logger, record_cursor &cursor) {
+    cursor.next(record_type::UNITS, sizeof(uint64_t), 2);
 }
 
-void read_lib_begin(spdlog::logger &logger, std::istream &stream) {
-    read_grp_begin<record_type::BGNLIB>(logger, stream);
+std::string read_struct_name(spdlog::logger &logger, record_cursor &cursor) {
+    return read_name<record_type::STRNAME>(logger, cursor);
 }
 
-std::string read_lib_name(spdlog::logger &logger, std::istream &stream) {
-    return read_name<record_type::LIBNAME>(logger, stream);
-}
-
-void read_units(spdlog::logger &logger, std::istream &stream) {
-    read_skip<record_type::UNITS, sizeof(uint64_t), 2>(stream);
-}
-
-std::string read_struct_name(spdlog::logger &logger, std::istream &stream) {
-    return read_name<record_type::STRNAME>(logger, stream);
-}
-
-void read_ele_end(spdlog::logger &logger, std::istream &stream) {
-    check_record_header<record_type::ENDEL, sizeof(uint16_t), 0>(stream);
+void read_ele_end(spdlog::logger &logger, record_cursor &cursor) {
+    cursor.next(record_type::ENDEL, sizeof(uint16_t), 0);
 }
 
 std::tuple<transformation, double> read_transform_info(spdlog::logger &logger,
-                                                       std::istream &stream) {
-    auto bit_flag = read_int<record_type::STRANS>(logger, stream);
+                                                       record_cursor &cursor) {
+    auto bit_flag = read_int<record_type::STRANS>(logger, cursor);
 
     auto ans = make_xform();
     if ((bit_flag & (1 << 15)) != 0) {
@@ -126,16 +81,14 @@ std::tuple<transformation, double> read_transform_info(spdlog::logger &logger,
 
     double mag = 1.0;
     double ang_dbl = 0.0;
-    auto [rec, size] = peek_record_header(stream);
-    switch (rec) {
+    switch (cursor.peek().type) {
     case record_type::MAG:
-        mag = read_double<record_type::MAG>(logger, stream);
-        rec = std::get<0>(peek_record_header(stream));
-        if (rec == record_type::ANGLE)
-            ang_dbl = read_double<record_type::ANGLE>(logger, stream);
+        mag = read_double<record_type::MAG>(logger, cursor);
+        if (cursor.peek().type == record_type::ANGLE)
+            ang_dbl = read_double<record_type::ANGLE>(logger, cursor);
         break;
     case record_type::ANGLE:
-        ang_dbl = read_double<record_type::ANGLE>(logger, stream);
+        ang_dbl = read_double<record_type::ANGLE>(logger, cursor);
         break;
     default:
         break;
@@ -161,51 +114,44 @@ std::tuple<transformation, double> read_transform_info(spdlog::logger &logger,
     return {ans, mag};
 }
 
-point read_point(std::istream &stream) {
-    auto x = read_bytes<int32_t>(stream);
-    auto y = read_bytes<int32_t>(stream);
-    return {x, y};
-}
-
 std::tuple<transformation, double> read_transform_mag(spdlog::logger &logger,
-                                                      std::istream &stream) {
-    auto ans = read_transform_info(logger, stream);
-    check_record_header<record_type::XY, sizeof(int32_t), 2>(stream);
-    auto [x, y] = read_point(stream);
+                                                      record_cursor &cursor) {
+    auto ans = read_transform_info(logger, cursor);
+    auto [x, y] = cursor.next(record_type::XY, sizeof(int32_t), 2).get_xy()[0];
     move_by(std::get<0>(ans), x, y);
 
     return ans;
 }
 
+transformation read_transform(spdlog::logger &logger, record_cursor &cursor) {
+    return std::get<0>(read_transform_mag(logger, cursor));
+}
+
 transformation read_transform(spdlog::logger &logger, std::istream &stream) {
-    return std::get<0>(read_transform_mag(logger, stream));
+    record_cursor cursor(read_records_until(stream, record_type::XY));
+    return read_transform(logger, cursor);
 }
 
 std::tuple<gds_layer_t, transformation, std::string, double> read_text(spdlog::logger &logger,
-                                                                       std::istream &stream) {
-    auto glay = read_int<record_type::LAYER>(logger, stream);
-    auto gpurp = read_int<record_type::TEXTTYPE>(logger, stream);
-    read_skip<record_type::PRESENTATION, sizeof(uint16_t), 1>(stream);
-    auto [xform, mag] = read_transform_mag(logger, stream);
+                                                                       record_cursor &cursor) {
+    auto glay = read_int<record_type::LAYER>(logger, cursor);
+    auto gpurp = read_int<record_type::TEXTTYPE>(logger, cursor);
+    cursor.next(record_type::PRESENTATION, sizeof(uint16_t), 1);
+    auto [xform, mag] = read_transform_mag(logger, cursor);
 
-    auto text = read_name<record_type::STRING>(logger, stream);
-    read_ele_end(logger, stream);
+    auto text = read_name<record_type::STRING>(logger, cursor);
+    read_ele_end(logger, cursor);
 
     return {gds_layer_t{glay, gpurp}, std::move(xform), std::move(text), mag};
 }
 
-std::tuple<gds_layer_t, layout::polygon> read_box(spdlog::logger &logger, std::istream &stream) {
-    auto glay = read_int<record_type::LAYER>(logger, stream);
-    auto gpurp = read_int<record_type::BOXTYPE>(logger, stream);
-    check_record_header<record_type::XY, sizeof(int32_t), 10>(stream);
+std::tuple<gds_layer_t, layout::polygon> read_box(spdlog::logger &logger, record_cursor &cursor) {
+    auto glay = read_int<record_type::LAYER>(logger, cursor);
+    auto gpurp = read_int<record_type::BOXTYPE>(logger, cursor);
+    auto xy = cursor.next(record_type::XY, sizeof(int32_t), 10).get_xy();
 
-    std::array<point, 5> pt_vec;
-    pt_vec[0] = read_point(stream);
-    pt_vec[1] = read_point(stream);
-    pt_vec[2] = read_point(stream);
-    pt_vec[3] = read_point(stream);
-    pt_vec[4] = read_point(stream);
-    read_ele_end(logger, stream);
+    std::array<point, 5> pt_vec{xy[0], xy[1], xy[2], xy[3], xy[4]};
+    read_ele_end(logger, cursor);
 
     layout::polygon poly;
     poly.set(pt_vec.begin(), pt_vec.end());
@@ -214,18 +160,14 @@ std::tuple<gds_layer_t, layout::polygon> read_box(spdlog::logger &logger, std::i
 }
 
 std::tuple<gds_layer_t, layout::polygon> read_boundary(spdlog::logger &logger,
-                                                       std::istream &stream) {
-    auto glay = read_int<record_type::LAYER>(logger, stream);
-    auto gpurp = read_int<record_type::DATATYPE>(logger, stream);
-    // divide by 2 to get number of points instead of number of coordinates.
-    auto num = check_record_header<record_type::XY, sizeof(int32_t)>(stream) / 2;
+                                                       record_cursor &cursor) {
+    auto glay = read_int<record_type::LAYER>(logger, cursor);
+    auto gpurp = read_int<record_type::DATATYPE>(logger, cursor);
+    auto rec = cursor.next(record_type::XY, 2 * sizeof(int32_t));
 
     std::vector<point> pt_vec;
-    pt_vec.reserve(num);
-    for (decltype(num) idx = 0; idx < num; ++idx) {
-        pt_vec.push_back(read_point(stream));
-    }
-    read_ele_end(logger, stream);
+    rec.get_xy().get_points(pt_vec);
+    read_ele_end(logger, cursor);
 
     layout::polygon poly;
     poly.set(pt_vec.begin(), pt_vec.end());
@@ -233,35 +175,35 @@ std::tuple<gds_layer_t, layout::polygon> read_boundary(spdlog::logger &logger,
     return {gds_layer_t{glay, gpurp}, std::move(poly)};
 }
 
-std::string read_inst_name(spdlog::logger &logger, std::istream &stream, std::size_t &cnt) {
-    auto [rtype, rsize] = read_record_header(stream);
+std::string read_inst_name(spdlog::logger &logger, record_cursor &cursor, std::size_t &cnt) {
+    auto rec = cursor.next();
     std::string inst_name;
-    switch (rtype) {
+    switch (rec.type) {
     case record_type::ENDEL:
         inst_name = "X" + std::to_string(cnt);
         ++cnt;
         break;
     case record_type::PROPATTR: {
-        auto prop_code = read_bytes<uint16_t>(stream);
+        auto prop_code = rec.get_uint16();
         if (prop_code != PROP_INST_NAME) {
             throw std::runtime_error(
                 fmt::format("Unexpected gds property code {} for instance.", prop_code));
         }
-        inst_name = read_name<record_type::PROPVALUE>(logger, stream);
-        read_ele_end(logger, stream);
+        inst_name = read_name<record_type::PROPVALUE>(logger, cursor);
+        read_ele_end(logger, cursor);
         break;
     }
     default:
         throw std::runtime_error(fmt::format("Unexpected gds record type {} at end of instance.",
-                                             static_cast<int>(rtype)));
+                                             static_cast<int>(rec.type)));
     }
     return inst_name;
 }
 
 layout::instance
-read_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt,
+read_instance(spdlog::logger &logger, record_cursor &cursor, std::size_t &cnt,
               const std::unordered_map<std::string, layout::cellview *> &master_map) {
-    auto cell_name = read_name<record_type::SNAME>(logger, stream);
+    auto cell_name = read_name<record_type::SNAME>(logger, cursor);
 
     auto iter = master_map.find(cell_name);
     if (iter == master_map.end()) {
@@ -270,15 +212,15 @@ read_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt,
         throw std::runtime_error(msg);
     }
     auto master = iter->second;
-    auto xform = read_transform(logger, stream);
-    auto inst_name = read_inst_name(logger, stream, cnt);
+    auto xform = read_transform(logger, cursor);
+    auto inst_name = read_inst_name(logger, cursor, cnt);
     return {std::move(inst_name), master, std::move(xform)};
 }
 
 layout::instance
-read_arr_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt,
+read_arr_instance(spdlog::logger &logger, record_cursor &cursor, std::size_t &cnt,
                   const std::unordered_map<std::string, layout::cellview *> &master_map) {
-    auto cell_name = read_name<record_type::SNAME>(logger, stream);
+    auto cell_name = read_name<record_type::SNAME>(logger, cursor);
 
     auto iter = master_map.find(cell_name);
     if (iter == master_map.end())
@@ -286,15 +228,12 @@ read_arr_instance(spdlog::logger &logger, std::istream &stream, std::size_t &cnt
             fmt::format("Cannot find layout cellview {} in GDS file.", cell_name));
     auto master = iter->second;
 
-    auto [xform, mag] = read_transform_info(logger, stream);
+    auto [xform, mag] = read_transform_info(logger, cursor);
 
-    auto [gds_nx, gds_ny] = read_col_row(logger, stream);
-    check_record_header<record_type::XY, sizeof(int32_t), 6>(stream);
-    std::array<point, 3> pt_vec;
-    pt_vec[0] = read_point(stream);
-    pt_vec[1] = read_point(stream);
-    pt_vec[2] = read_point(stream);
-    auto inst_name = read_inst_name(logger, stream, cnt);
+    auto [gds_nx, gds_ny] = read_col_row(logger, cursor);
+    auto xy = cursor.next(record_type::XY, sizeof(int32_t), 6).get_xy();
+    std::array<point, 3> pt_vec{xy[0], xy[1], xy[2]};
+    auto inst_name = read_inst_name(logger, cursor, cnt);
 
     move_by(xform, pt_vec[0][0], pt_vec[0][1]);
     auto gds_spx = pt_vec[1][0] / gds_nx;
@@ -0,0 +1,208 @@
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CBAG_GDSII_USE_MMAP 1
+#else
+#define CBAG_GDSII_USE_MMAP 0
+#endif
+
+#include <fmt/core.h>
+
+#include <cbag/gdsii/record_cursor.h>
+#include <cbag/util/io.h>
+
+namespace cbag {
+namespace gdsii {
+
+constexpr std::size_t HEADER_SIZE = 4;
+
+std::size_t record_view::check(record_type rtype, std::size_t unit_size,
+                               std::size_t num_data) const {
+    if (type != rtype)
+        throw std::runtime_error(fmt::format("got gds record {:#x}, expected {:#x}",
+                                             static_cast<int>(type), static_cast<int>(rtype)));
+
+    auto ans = size / unit_size;
+    auto mod = size % unit_size;
+    if (mod != 0)
+        throw std::runtime_error(
+            fmt::format("gds record size {} not divisible by unit size {}", size, unit_size));
+
+    if (num_data != 0 && ans != num_data) {
+        throw std::runtime_error(
+            fmt::format("gds record has {} elements, expected {}", ans, num_data));
+    }
+    return ans;
+}
+
+struct record_cursor::helper {
+    static void map_file(record_cursor &self, const std::string &fname) {
+#if CBAG_GDSII_USE_MMAP
+        auto fd = ::open(fname.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            auto size = static_cast<std::size_t>(info.st_size);
+            auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED) {
+                ::madvise(ptr, size, MADV_SEQUENTIAL);
+                self.map_ptr = ptr;
+                self.map_size = size;
+                self.start = static_cast<const char *>(ptr);
+                self.total = size;
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    static void unmap(record_cursor &self) noexcept {
+#if CBAG_GDSII_USE_MMAP
+        if (self.map_ptr)
+            ::munmap(self.map_ptr, self.map_size);
+#endif
+        self.map_ptr = nullptr;
+        self.map_size = 0;
+    }
+
+    static void use_buffer(record_cursor &self) noexcept {
+        self.start = self.buffer.data();
+        self.total = self.buffer.size();
+    }
+
+    static record_view get_record(const record_cursor &self) {
+        if (self.total - self.pos < HEADER_SIZE)
+            throw std::runtime_error(
+                fmt::format("Unexpected end of GDS data at byte {}.", self.pos));
+
+        auto cur = self.start + self.pos;
+        auto rsize = static_cast<std::size_t>(decode_bytes<uint16_t>(cur));
+        if (rsize < HEADER_SIZE || rsize > self.total - self.pos)
+            throw std::runtime_error(
+                fmt::format("Invalid GDS record size {} at byte {}.", rsize, self.pos));
+
+        auto rtype = static_cast<record_type>(decode_bytes<uint16_t>(cur + 2));
+        return {rtype, cur + HEADER_SIZE, rsize - HEADER_SIZE};
+    }
+};
+
+record_cursor::record_cursor(const std::string &fname, bool use_mmap) {
+    if (!util::is_file(fname))
+        throw std::invalid_argument(fname + " is not a file.");
+
+    if (use_mmap)
+        helper::map_file(*this, fname);
+    if (!map_ptr) {
+        auto stream = util::open_file_read(fname, true);
+        stream.seekg(0, std::ios::end);
+        buffer.resize(static_cast<std::size_t>(stream.tellg()));
+        stream.seekg(0, std::ios::beg);
+        stream.read(buffer.data(), buffer.size());
+        if (stream.fail())
+            throw std::runtime_error("Error reading " + fname + ": " + std::strerror(errno));
+        helper::use_buffer(*this);
+    }
+}
+
+record_cursor::record_cursor(std::istream &stream)
+    : buffer(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) {
+    helper::use_buffer(*this);
+}
+
+record_cursor::record_cursor(std::vector<char> &&data) : buffer(std::move(data)) {
+    helper::use_buffer(*this);
+}
+
+record_cursor::record_cursor() = default;
+
+record_cursor::record_cursor(record_cursor &&other) noexcept { *this = std::move(other); }
+
+record_cursor &record_cursor::operator=(record_cursor &&other) noexcept {
+    if (this != &other) {
+        helper::unmap(*this);
+        map_ptr = std::exchange(other.map_ptr, nullptr);
+        map_size = std::exchange(other.map_size, 0);
+        // moving a vector keeps its storage, so start stays valid for buffered data.
+        buffer = std::move(other.buffer);
+        start = std::exchange(other.start, nullptr);
+        total = std::exchange(other.total, 0);
+        pos = std::exchange(other.pos, 0);
+    }
+    return *this;
+}
+
+record_cursor::~record_cursor() { helper::unmap(*this); }
+
+bool record_cursor::is_mapped() const noexcept { return map_ptr != nullptr; }
+
+bool record_cursor::at_end() const noexcept { return pos >= total; }
+
+const char *record_cursor::data() const noexcept { return start; }
+
+std::size_t record_cursor::size() const noexcept { return total; }
+
+std::size_t record_cursor::tell() const noexcept { return pos; }
+
+void record_cursor::seek(std::size_t offset) {
+    if (offset > total)
+        throw std::out_of_range(
+            fmt::format("GDS offset {} out of range [0, {}].", offset, total));
+    pos = offset;
+}
+
+record_cursor record_cursor::slice(std::size_t offset, std::size_t stop) const {
+    if (offset > stop || stop > total)
+        throw std::out_of_range(
+            fmt::format("GDS byte range [{}, {}) out of range [0, {}].", offset, stop, total));
+    record_cursor ans;
+    ans.start = start + offset;
+    ans.total = stop - offset;
+    return ans;
+}
+
+record_view record_cursor::peek() const { return helper::get_record(*this); }
+
+record_view record_cursor::next() {
+    auto ans = helper::get_record(*this);
+    pos += ans.size + HEADER_SIZE;
+    return ans;
+}
+
+record_view record_cursor::next(record_type rtype, std::size_t unit_size, std::size_t num_data) {
+    auto ans = next();
+    ans.check(rtype, unit_size, num_data);
+    return ans;
+}
+
+std::vector<char> read_records_until(std::istream &stream, record_type stop) {
+    std::vector<char> ans;
+    while (true) {
+        auto offset = ans.size();
+        ans.resize(offset + HEADER_SIZE);
+        if (!stream.read(ans.data() + offset, HEADER_SIZE))
+            throw std::runtime_error("Unexpected end of GDS stream.");
+        auto rsize = static_cast<std::size_t>(decode_bytes<uint16_t>(ans.data() + offset));
+        auto rtype = static_cast<record_type>(decode_bytes<uint16_t>(ans.data() + offset + 2));
+        if (rsize < HEADER_SIZE)
+            throw std::runtime_error(fmt::format("Invalid GDS record size {}.", rsize));
+
+        auto data_size = rsize - HEADER_SIZE;
+        ans.resize(offset + rsize);
+        if (data_size > 0 && !stream.read(ans.data() + offset + HEADER_SIZE, data_size))
+            throw std::runtime_error("Unexpected end of GDS stream.");
+        if (rtype == stop)
+            return ans;
+    }
+}
+
+} // namespace gdsii
+} // namespace cbag
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <cbag/gdsii/read.h>
+#include <cbag/gdsii/record_cursor.h>
+#include <cbag/gdsii/struct_index.h>
+
+namespace cbag {
+namespace gdsii {
+
+struct struct_index::helper {
+    static void scan(struct_index &self, spdlog::logger &logger, record_cursor &cursor,
+                     std::vector<std::vector<std::string>> &ref_list) {
+        self.lib_name = read_gds_start(logger, cursor);
+        while (true) {
+            auto rtype = cursor.next().type;
+            switch (rtype) {
+            case record_type::BGNSTR: {
+                struct_info info;
+                info.start = cursor.tell();
+                info.name = std::string(cursor.next(record_type::STRNAME).get_string());
+                auto &refs = ref_list.emplace_back();
+                for (auto rec = cursor.next(); rec.type != record_type::ENDSTR;
+                     rec = cursor.next()) {
+                    if (rec.type == record_type::SNAME)
+                        refs.emplace_back(rec.get_string());
+                }
+                info.stop = cursor.tell();
+                self.name_map.emplace(info.name, self.info_list.size());
+                self.info_list.push_back(std::move(info));
+                break;
+            }
+            case record_type::ENDLIB:
+                return;
+            default:
+                throw std::runtime_error("Unrecognized GDS record type: " +
+                                         std::to_string(static_cast<int>(rtype)));
+            }
+        }
+    }
+};
+
+struct_index::struct_index(spdlog::logger &logger, record_cursor &cursor) {
+    auto pos = cursor.tell();
+    cursor.seek(0);
+    std::vector<std::vector<std::string>> ref_list;
+    helper::scan(*this, logger, cursor, ref_list);
+    cursor.seek(pos);
+
+    for (std::size_t idx = 0; idx < info_list.size(); ++idx) {
+        auto &deps = info_list[idx].deps;
+        for (const auto &ref : ref_list[idx]) {
+            auto dep_idx = find(ref);
+            if (dep_idx != npos)
+                deps.push_back(dep_idx);
+        }
+        std::sort(deps.begin(), deps.end());
+        deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+    }
+}
+
+const std::string &struct_index::get_lib_name() const noexcept { return lib_name; }
+
+std::size_t struct_index::size() const noexcept { return info_list.size(); }
+
+const struct_info &struct_index::operator[](std::size_t idx) const { return info_list[idx]; }
+
+std::size_t struct_index::find(const std::string &name) const {
+    auto iter = name_map.find(name);
+    return (iter == name_map.end()) ? npos : iter->second;
+}
+
+std::vector<std::size_t> struct_index::get_closure(std::size_t idx) const {
+    if (idx >= info_list.size())
+        throw std::out_of_range(fmt::format("GDS structure index {} out of range.", idx));
+
+    std::vector<bool> visited(info_list.size(), false);
+    std::vector<std::size_t> stack{idx};
+    visited[idx] = true;
+    std::vector<std::size_t> ans;
+    while (!stack.empty()) {
+        auto cur = stack.back();
+        stack.pop_back();
+        ans.push_back(cur);
+        for (auto dep : info_list[cur].deps) {
+            if (!visited[dep]) {
+                visited[dep] = true;
+                stack.push_back(dep);
+            }
+        }
+    }
+    std::sort(ans.begin(), ans.end());
+    return ans;
+}
+
+std::vector<std::vector<std::size_t>> struct_index::get_waves() const {
+    std::vector<std::size_t> idx_list(info_list.size());
+    std::iota(idx_list.begin(), idx_list.end(), 0);
+    return get_waves(idx_list);
+}
+
+std::vector<std::vector<std::size_t>>
+struct_index::get_waves(const std::vector<std::size_t> &idx_list) const {
+    // the wave of a structure is one more than the largest wave of its masters.
+    auto num = info_list.size();
+    std::vector<std::size_t> num_left(num, 0);
+    std::vector<std::vector<std::size_t>> parents(num);
+    std::vector<std::size_t> cur;
+    for (auto idx : idx_list) {
+        auto &deps = info_list[idx].deps;
+        num_left[idx] = deps.size();
+        for (auto dep : deps) {
+            parents[dep].push_back(idx);
+        }
+        if (deps.empty())
+            cur.push_back(idx);
+    }
+
+    std::vector<std::vector<std::size_t>> ans;
+    std::size_t num_done = 0;
+    while (!cur.empty()) {
+        std::vector<std::size_t> next;
+        for (auto idx : cur) {
+            for (auto parent : parents[idx]) {
+                if (--num_left[parent] == 0)
+                    next.push_back(parent);
+            }
+        }
+        std::sort(next.begin(), next.end());
+        num_done += cur.size();
+        ans.push_back(std::move(cur));
+        cur = std::move(next);
+    }
+
+    if (num_done != idx_list.size()) {
+        auto iter = std::find_if(num_left.begin(), num_left.end(), [](auto v) { return v > 0; });
+        auto &name = info_list[iter - num_left.begin()].name;
+        throw std::runtime_error(
+            fmt::format("GDS instance hierarchy of structure {} has a cycle.", name));
+    }
+    return ans;
+}
+
+} // namespace gdsii
+} // namespace cbag
@@ -6,6 +6,7 @@
 #include <cbag/gdsii/write.h>
 #include <cbag/gdsii/write_util.h>
 #include <cbag/layout/cellview.h>
+#include <cbag/layout/cellview_util.h>
 #include <cbag/layout/polygon.h>
 #include <cbag/layout/via_util.h>
 
@@ -18,14 +19,14 @@ class polygon_writer {
 
   private:
     spdlog::logger &logger;
-    std::ostream &stream;
+    write_buffer &buf;
     glay_t layer;
     gpurp_t purpose;
     value_type last;
 
   public:
-    polygon_writer(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose)
-        : logger(logger), stream(stream), layer(layer), purpose(purpose) {}
+    polygon_writer(spdlog::logger &logger, write_buffer &buf, glay_t layer, gpurp_t purpose)
+        : logger(logger), buf(buf), layer(layer), purpose(purpose) {}
 
     void push_back(value_type &&v) {
         record_last();
@@ -39,7 +40,7 @@ class polygon_writer {
 
     void record_last() const {
         if (last.size() > 0) {
-            write_polygon(logger, stream, layer, purpose, last);
+            write_polygon(logger, buf, layer, purpose, last);
         }
     }
 
@@ -51,16 +52,16 @@ class polygon_writer {
 class rect_writer {
   private:
     spdlog::logger &logger;
-    std::ostream &stream;
+    write_buffer &buf;
     glay_t layer;
     gpurp_t purpose;
 
   public:
-    rect_writer(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose)
-        : logger(logger), stream(stream), layer(layer), purpose(purpose) {}
+    rect_writer(spdlog::logger &logger, write_buffer &buf, glay_t layer, gpurp_t purpose)
+        : logger(logger), buf(buf), layer(layer), purpose(purpose) {}
 
     rect_writer &operator=(const box_t &box) {
-        write_box(logger, stream, layer, purpose, box);
+        write_box(logger, buf, layer, purpose, box);
         return *this;
     }
 
@@ -133,26 +134,39 @@ std::vector<tval_t> get_gds_time() {
     };
 }
 
+void write_gds_start(spdlog::logger &logger, write_buffer &buf, const std::string &lib_name,
+                     double resolution, double user_unit, const std::vector<tval_t> &time_vec) {
+    write_header(logger, buf);
+    write_lib_begin(logger, buf, time_vec);
+    write_lib_name(logger, buf, lib_name);
+    write_units(logger, buf, resolution, user_unit);
+}
+
 void write_gds_start(spdlog::logger &logger, std::ostream &stream, const std::string &lib_name,
                      double resolution, double user_unit, const std::vector<tval_t> &time_vec) {
-    write_header(logger, stream);
-    write_lib_begin(logger, stream, time_vec);
-    write_lib_name(logger, stream, lib_name);
-    write_units(logger, stream, resolution, user_unit);
+    write_buffer buf(stream);
+    write_gds_start(logger, buf, lib_name, resolution, user_unit, time_vec);
+    buf.flush();
 }
 
-void write_gds_stop(spdlog::logger &logger, std::ostream &stream) { write_lib_end(logger, stream); }
+void write_gds_stop(spdlog::logger &logger, write_buffer &buf) { write_lib_end(logger, buf); }
 
-void write_lay_geometry(spdlog::logger &logger, std::ostream &stream, glay_t lay, gpurp_t purp,
+void write_gds_stop(spdlog::logger &logger, std::ostream &stream) {
+    write_buffer buf(stream);
+    write_gds_stop(logger, buf);
+    buf.flush();
+}
+
+void write_lay_geometry(spdlog::logger &logger, write_buffer &buf, glay_t lay, gpurp_t purp,
                         const layout::geometry &geo) {
-    polygon_writer w(logger, stream, lay, purp);
+    polygon_writer w(logger, buf, lay, purp);
     geo.write_geometry(w);
     w.record_last();
 }
 
-void write_lay_via(spdlog::logger &logger, std::ostream &stream, const layout::tech &tech,
+void write_lay_via(spdlog::logger &logger, write_buffer &buf, const layout::tech &tech,
                    const gds_lookup &lookup, const layout::via &v) {
-    auto [lay1_key, cut_key, lay2_key] = tech.get_via_layer_purpose(v.get_via_id());
+    auto [lay1_key, cut_key, lay2_key] = tech.get_via_layer_purpose(v.get_via_def());
     auto gkey1 = lookup.get_gds_layer(lay1_key);
     if (!gkey1) {
         logger.warn("Cannot find layer/purpose ({}, {}) in layer map.  Skipping via.",
@@ -174,12 +188,12 @@ void write_lay_via(spdlog::logger &logger, std::ostream &stream, const layout::t
     auto [glay1, gpurp1] = *gkey1;
     auto [gcl, gcp] = *gkeyc;
     auto [glay2, gpurp2] = *gkey2;
-    write_box(logger, stream, glay1, gpurp1, layout::get_bot_box(v));
-    write_box(logger, stream, glay2, gpurp2, layout::get_top_box(v));
-    get_via_cuts(v, rect_writer(logger, stream, gcl, gcp));
+    write_box(logger, buf, glay1, gpurp1, layout::get_bot_box(v));
+    write_box(logger, buf, glay2, gpurp2, layout::get_top_box(v));
+    get_via_cuts(v, rect_writer(logger, buf, gcl, gcp));
 }
 
-void write_lay_pin(spdlog::logger &logger, std::ostream &stream, glay_t lay, gpurp_t purp,
+void write_lay_pin(spdlog::logger &logger, write_buffer &buf, glay_t lay, gpurp_t purp,
                    const layout::pin &pin, bool make_pin_obj, double resolution) {
     if (!is_physical(pin)) {
         logger.warn("non-physical bbox {} on pin layer ({}, {}), skipping.", to_string(pin), lay,
@@ -198,34 +212,37 @@ void write_lay_pin(spdlog::logger &logger, std::ostream &stream, glay_t lay, gpu
         xform = make_xform(xc, yc, oR0);
     }
 
-    write_text(logger, stream, lay, purp, pin.get_label(), xform, text_h, resolution);
+    write_text(logger, buf, lay, purp, pin.get_label(), xform, text_h, resolution);
     if (make_pin_obj) {
-        write_box(logger, stream, lay, purp, pin);
+        write_box(logger, buf, lay, purp, pin);
     }
 }
 
-void write_lay_label(spdlog::logger &logger, std::ostream &stream, const layout::label &lab,
+void write_lay_label(spdlog::logger &logger, write_buffer &buf, const layout::label &lab,
                      double resolution) {
     auto [lay, purp] = lab.get_key();
-    write_text(logger, stream, lay, purp, lab.get_text(), lab.get_xform(), lab.get_height(),
+    write_text(logger, buf, lay, purp, lab.get_text(), lab.get_xform(), lab.get_height(),
                resolution);
 }
 
-void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
+void write_lay_cellview(spdlog::logger &logger, write_buffer &buf, const std::string &cell_name,
                         const cbag::layout::cellview &cv,
                         const std::unordered_map<std::string, std::string> &rename_map,
-                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup) {
-    write_struct_begin(logger, stream, time_vec);
-    write_struct_name(logger, stream, cell_name);
+                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup,
+                        std::size_t num_workers) {
+    write_struct_begin(logger, buf, time_vec);
+    write_struct_name(logger, buf, cell_name);
 
     logger.info("Export layout instances.");
     for (auto iter = cv.begin_inst(); iter != cv.end_inst(); ++iter) {
         auto &[inst_name, inst] = *iter;
-        write_instance(logger, stream, inst.get_cell_name(&rename_map), inst_name, inst.xform,
+        write_instance(logger, buf, inst.get_cell_name(&rename_map), inst_name, inst.xform,
                        inst.nx, inst.ny, inst.spx, inst.spy);
     }
 
     logger.info("Export layout geometries.");
+    // merge all layers concurrently, then write in the usual order
+    layout::merge_geometry(cv, num_workers);
     for (auto iter = cv.begin_geometry(); iter != cv.end_geometry(); ++iter) {
         auto &[layer_key, geo] = *iter;
         auto gkey = lookup.get_gds_layer(layer_key);
@@ -234,16 +251,16 @@ void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std:
                         layer_key.first, layer_key.second);
         } else {
             auto [glay, gpurp] = *gkey;
-            write_lay_geometry(logger, stream, glay, gpurp, geo);
+            write_lay_geometry(logger, buf, glay, gpurp, geo);
         }
     }
 
     logger.info("Export layout vias.");
     auto tech_ptr = cv.get_tech();
     auto resolution = tech_ptr->get_resolution();
-    for (auto iter = cv.begin_via(); iter != cv.end_via(); ++iter) {
-        write_lay_via(logger, stream, *tech_ptr, lookup, *iter);
-    }
+    cv.for_each_via([&logger, &buf, &tech_ptr, &lookup](const layout::via &v) {
+        write_lay_via(logger, buf, *tech_ptr, lookup, v);
+    });
 
     logger.info("Export layout pins.");
     auto purp = tech_ptr->get_pin_purpose();
@@ -257,14 +274,14 @@ void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std:
         } else {
             auto [glay, gpurp] = *gkey;
             for (const auto &pin : pin_list) {
-                write_lay_pin(logger, stream, glay, gpurp, pin, make_pin_obj, resolution);
+                write_lay_pin(logger, buf, glay, gpurp, pin, make_pin_obj, resolution);
             }
         }
     }
 
     logger.info("Export layout labels.");
     for (auto iter = cv.begin_label(); iter != cv.end_label(); ++iter) {
-        write_lay_label(logger, stream, *iter, resolution);
+        write_lay_label(logger, buf, *iter, resolution);
     }
 
     logger.info("Export layout boundaries.");
@@ -275,14 +292,24 @@ void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std:
             logger.warn("Cannot find boundary type {} in object map.  Skipping boundary.", btype);
         } else {
             auto [glay, gpurp] = *gkey;
-            write_polygon(logger, stream, glay, gpurp, *iter);
+            write_polygon(logger, buf, glay, gpurp, *iter);
         }
     }
 
-    write_struct_end(logger, stream);
+    write_struct_end(logger, buf);
 
     logger.info("Finish GDS export.");
 }
 
+void write_lay_cellview(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
+                        const cbag::layout::cellview &cv,
+                        const std::unordered_map<std::string, std::string> &rename_map,
+                        const std::vector<tval_t> &time_vec, const gds_lookup &lookup,
+                        std::size_t num_workers) {
+    write_buffer buf(stream);
+    write_lay_cellview(logger, buf, cell_name, cv, rename_map, time_vec, lookup, num_workers);
+    buf.flush();
+}
+
 } // namespace gdsii
 } // namespace cbag
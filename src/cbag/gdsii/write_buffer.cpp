@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <cbag/gdsii/write_buffer.h>
+
+namespace cbag {
+namespace gdsii {
+
+write_buffer::write_buffer(std::ostream &stream, std::size_t capacity)
+    : stream(stream), capacity(capacity) {}
+
+write_buffer::~write_buffer() {
+    // errors cannot be reported from a destructor; they leave the stream in a failed state.
+    if (pos > 0 && stream.good())
+        stream.write(data.data(), pos);
+}
+
+void write_buffer::flush() {
+    if (pos > 0) {
+        stream.write(data.data(), pos);
+        pos = 0;
+        if (stream.fail())
+            throw std::runtime_error(std::string("Error writing GDS data: ") +
+                                     std::strerror(errno));
+    }
+}
+
+void write_buffer::make_room(std::size_t num) {
+    if (pos + num > capacity)
+        flush();
+    // grow geometrically, so short writes only touch the memory they use
+    auto need = pos + num;
+    if (data.size() < need)
+        data.resize(std::max(need, std::min(2 * data.size(), capacity)));
+}
+
+} // namespace gdsii
+} // namespace cbag
@@ -1,10 +1,13 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 #include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation_util.h>
+#include <cbag/gdsii/byte_swap.h>
 #include <cbag/gdsii/math.h>
 #include <cbag/gdsii/record_type.h>
 #include <cbag/gdsii/write_util.h>
@@ -22,112 +25,74 @@ constexpr auto SIZE_SIZE = sizeof(size_type);
 constexpr auto VERSION = static_cast<uint16_t>(5);
 constexpr auto TEXT_PRESENTATION = static_cast<uint16_t>(0x0005);
 
-template <typename T, typename U> T interpret_as(U val) { return *reinterpret_cast<T *>(&val); }
-
-class uchar_iter {
-  private:
-    std::string::const_iterator iter;
-
-  public:
-    uchar_iter() = default;
-    explicit uchar_iter(std::string::const_iterator iter) : iter(std::move(iter)) {}
-
-    unsigned char operator*() { return interpret_as<unsigned char>(*iter); }
-    uchar_iter &operator++() {
-        ++iter;
-        return *this;
-    }
-    bool operator!=(const uchar_iter &other) { return iter != other.iter; }
-};
-
-template <typename iT> class point_xy_iter {
-  private:
-    iT pt_iter;
-    bool is_y = false;
-
-  public:
-    point_xy_iter() = default;
-    explicit point_xy_iter(iT pt_iter, bool is_y = false)
-        : pt_iter(std::move(pt_iter)), is_y(is_y) {}
-
-    uint32_t operator*() const {
-        auto val = (is_y) ? pt_iter->y() : pt_iter->x();
-        return *reinterpret_cast<uint32_t *>(&val);
-    }
-
-    uint32_t x() const { return pt_iter->x(); }
+// claims a record with the given number of data bytes, and returns a pointer to the data.
+template <record_type R> char *write_record_header(write_buffer &buf, std::size_t num_bytes) {
+    auto size_test = num_bytes + SIZE_SIZE + TYPE_SIZE;
+    assert(size_test <= MAX_SIZE);
 
-    uint32_t y() const { return pt_iter->y(); }
+    // records have even sizes, so pad with a zero byte if needed.
+    auto pad = size_test % 2;
+    auto ptr = buf.claim(size_test + pad);
+    encode_bytes(ptr, static_cast<size_type>(size_test + pad));
+    encode_bytes(ptr + SIZE_SIZE, static_cast<uint16_t>(R));
+    if (pad)
+        ptr[size_test] = '\0';
+    return ptr + SIZE_SIZE + TYPE_SIZE;
+}
 
-    point_xy_iter &operator++() {
-        if (is_y) {
-            ++pt_iter;
+template <record_type R, typename T, std::size_t N>
+void write(write_buffer &buf, const std::array<T, N> &data) {
+    auto ptr = write_record_header<R>(buf, sizeof(T) * N);
+    if constexpr (std::is_same_v<T, int32_t>) {
+        encode_int32_array(data.data(), ptr, N);
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        encode_uint64_array(data.data(), ptr, N);
+    } else {
+        for (auto val : data) {
+            encode_bytes(ptr, static_cast<std::make_unsigned_t<T>>(val));
+            ptr += sizeof(T);
         }
-        is_y = !is_y;
-        return *this;
-    }
-    bool operator!=(const point_xy_iter &other) const noexcept {
-        return pt_iter != other.pt_iter || is_y != other.is_y;
-    }
-};
-
-template <record_type R, typename iT>
-void write(std::ostream &stream, std::size_t num_data, iT start, iT stop) {
-    constexpr auto unit_size = sizeof(*start);
-
-    auto size_test = unit_size * num_data + SIZE_SIZE + TYPE_SIZE;
-    assert(size_test <= MAX_SIZE);
-
-    auto size = static_cast<size_type>(size_test);
-    bool add_zero = false;
-    if (size % 2 == 1) {
-        ++size;
-        add_zero = true;
-    }
-    write_bytes(stream, size);
-    write_bytes(stream, static_cast<uint16_t>(R));
-    for (; start != stop; ++start) {
-        write_bytes(stream, *start);
-    }
-    if (add_zero) {
-        stream.put('\0');
     }
 }
 
 template <record_type R>
-void write_grp_begin(spdlog::logger &logger, std::ostream &stream,
+void write_grp_begin(spdlog::logger &logger, write_buffer &buf,
                      const std::vector<tval_t> &time_vec) {
-    std::vector<tval_t> data(time_vec.begin(), time_vec.end());
-    data.insert(data.end(), time_vec.begin(), time_vec.end());
-    write<R>(stream, data.size(), data.begin(), data.end());
+    // modification time followed by access time
+    auto ptr = write_record_header<R>(buf, 2 * sizeof(tval_t) * time_vec.size());
+    for (auto rep = 0; rep < 2; ++rep) {
+        for (auto val : time_vec) {
+            encode_bytes(ptr, val);
+            ptr += sizeof(tval_t);
+        }
+    }
 }
 
-template <record_type R> void write_empty(spdlog::logger &logger, std::ostream &stream) {
-    std::array<uint16_t, 0> tmp;
-    write<R>(stream, tmp.size(), tmp.begin(), tmp.end());
+template <record_type R> void write_empty(spdlog::logger &logger, write_buffer &buf) {
+    write_record_header<R>(buf, 0);
 }
 
 template <record_type R>
-void write_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
-    write<R>(stream, name.size(), uchar_iter(name.begin()), uchar_iter(name.end()));
+void write_name(spdlog::logger &logger, write_buffer &buf, const std::string &name) {
+    auto ptr = write_record_header<R>(buf, name.size());
+    std::memcpy(ptr, name.data(), name.size());
 }
 
-template <record_type R>
-void write_int(spdlog::logger &logger, std::ostream &stream, uint16_t val) {
-    std::array<uint16_t, 1> tmp{val};
-    write<R>(stream, tmp.size(), tmp.begin(), tmp.end());
+template <record_type R> void write_int(spdlog::logger &logger, write_buffer &buf, uint16_t val) {
+    write<R>(buf, std::array<uint16_t, 1>{val});
 }
 
-template <typename iT>
-void write_points(spdlog::logger &logger, std::ostream &stream, std::size_t num_pts, iT begin,
-                  iT end) {
-    auto start_iter = point_xy_iter(begin);
-    auto xval = start_iter.x();
-    auto yval = start_iter.y();
-    write<record_type::XY>(stream, 2 * (num_pts + 1), std::move(start_iter), point_xy_iter(end));
-    // write first point
-    write_bytes(stream, xval);
-    write_bytes(stream, yval);
+void write_points(spdlog::logger &logger, write_buffer &buf, const layout::polygon &poly) {
+    using point_type = layout::polygon::point_type;
+    static_assert(sizeof(point_type) == 2 * sizeof(int32_t), "polygon points must be packed");
+
+    // the first point is repeated at the end to close the polygon.
+    auto num_pts = poly.size();
+    auto ptr = write_record_header<record_type::XY>(buf, 8 * (num_pts + 1));
+    if (num_pts > 0) {
+        encode_int32_array(reinterpret_cast<const int32_t *>(&*poly.begin()), ptr, 2 * num_pts);
+        std::memcpy(ptr + 8 * num_pts, ptr, 8);
+    }
 }
 
 std::tuple<uint32_t, uint16_t> get_angle_flag(orientation orient) {
@@ -154,24 +119,24 @@ std::tuple<uint32_t, uint16_t> get_angle_flag(orientation orient) {
     }
 }
 
-void write_transform(spdlog::logger &logger, std::ostream &stream, const transformation &xform,
+void write_transform(spdlog::logger &logger, write_buffer &buf, const transformation &xform,
                      double mag, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy) {
     auto [angle, bit_flag] = get_angle_flag(orient(xform));
 
-    write_int<record_type::STRANS>(logger, stream, bit_flag);
+    write_int<record_type::STRANS>(logger, buf, bit_flag);
     if (mag != 1.0) {
         std::array<uint64_t, 1> data{double_to_gds(mag)};
-        write<record_type::MAG>(stream, data.size(), data.begin(), data.end());
+        write<record_type::MAG>(buf, data);
     }
     if (angle != 0) {
         std::array<uint64_t, 1> data{double_to_gds((double)angle)};
-        write<record_type::ANGLE>(stream, data.size(), data.begin(), data.end());
+        write<record_type::ANGLE>(buf, data);
     }
     if (nx > 1 || ny > 1) {
         // convert BAG array parameters to GDS array parameters
         auto [gds_nx, gds_ny, gds_spx, gds_spy] = cbag::convert_array(xform, nx, ny, spx, spy);
         std::array<uint16_t, 2> nxy{static_cast<uint16_t>(gds_nx), static_cast<uint16_t>(gds_ny)};
-        write<record_type::COLROW>(stream, nxy.size(), nxy.begin(), nxy.end());
+        write<record_type::COLROW>(buf, nxy);
         auto [x1, y1] = location(xform);
         decltype(spx) x2 = gds_spx * gds_nx;
         decltype(spx) y2 = 0;
@@ -179,120 +144,194 @@ void write_transform(spdlog::logger &logger, std::ostream &stream, const transfo
         decltype(spx) y3 = gds_spy * gds_ny;
         xform.transform(x2, y2);
         xform.transform(x3, y3);
-        std::array<uint32_t, 6> xy{interpret_as<uint32_t>(x1), interpret_as<uint32_t>(y1),
-                                   interpret_as<uint32_t>(x2), interpret_as<uint32_t>(y2),
-                                   interpret_as<uint32_t>(x3), interpret_as<uint32_t>(y3)};
-        write<record_type::XY>(stream, xy.size(), xy.begin(), xy.end());
+        std::array<int32_t, 6> xy{x1, y1, x2, y2, x3, y3};
+        write<record_type::XY>(buf, xy);
     } else {
-        std::array<uint32_t, 2> xy{interpret_as<uint32_t>(x(xform)),
-                                   interpret_as<uint32_t>(y(xform))};
-        write<record_type::XY>(stream, xy.size(), xy.begin(), xy.end());
+        std::array<int32_t, 2> xy{x(xform), y(xform)};
+        write<record_type::XY>(buf, xy);
     }
 }
 
-void write_header(spdlog::logger &logger, std::ostream &stream) {
-    write_int<record_type::HEADER>(logger, stream, VERSION);
+void write_header(spdlog::logger &logger, write_buffer &buf) {
+    write_int<record_type::HEADER>(logger, buf, VERSION);
 }
 
-void write_units(spdlog::logger &logger, std::ostream &stream, double resolution,
+void write_units(spdlog::logger &logger, write_buffer &buf, double resolution,
                  double user_unit) {
     std::array<uint64_t, 2> data{double_to_gds(resolution), double_to_gds(resolution * user_unit)};
-    write<record_type::UNITS>(stream, data.size(), data.begin(), data.end());
+    write<record_type::UNITS>(buf, data);
 }
 
-void write_lib_begin(spdlog::logger &logger, std::ostream &stream,
+void write_lib_begin(spdlog::logger &logger, write_buffer &buf,
                      const std::vector<tval_t> &time_vec) {
-    write_grp_begin<record_type::BGNLIB>(logger, stream, time_vec);
+    write_grp_begin<record_type::BGNLIB>(logger, buf, time_vec);
 }
 
-void write_lib_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
-    write_name<record_type::LIBNAME>(logger, stream, name);
+void write_lib_name(spdlog::logger &logger, write_buffer &buf, const std::string &name) {
+    write_name<record_type::LIBNAME>(logger, buf, name);
 }
 
-void write_lib_end(spdlog::logger &logger, std::ostream &stream) {
-    write_empty<record_type::ENDLIB>(logger, stream);
+void write_lib_end(spdlog::logger &logger, write_buffer &buf) {
+    write_empty<record_type::ENDLIB>(logger, buf);
 }
 
-void write_struct_begin(spdlog::logger &logger, std::ostream &stream,
+void write_struct_begin(spdlog::logger &logger, write_buffer &buf,
                         const std::vector<tval_t> &time_vec) {
-    write_grp_begin<record_type::BGNSTR>(logger, stream, time_vec);
+    write_grp_begin<record_type::BGNSTR>(logger, buf, time_vec);
 }
 
-void write_struct_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
-    write_name<record_type::STRNAME>(logger, stream, name);
+void write_struct_name(spdlog::logger &logger, write_buffer &buf, const std::string &name) {
+    write_name<record_type::STRNAME>(logger, buf, name);
 }
 
-void write_struct_end(spdlog::logger &logger, std::ostream &stream) {
-    write_empty<record_type::ENDSTR>(logger, stream);
+void write_struct_end(spdlog::logger &logger, write_buffer &buf) {
+    write_empty<record_type::ENDSTR>(logger, buf);
 }
 
-void write_element_end(spdlog::logger &logger, std::ostream &stream) {
-    write_empty<record_type::ENDEL>(logger, stream);
+void write_element_end(spdlog::logger &logger, write_buffer &buf) {
+    write_empty<record_type::ENDEL>(logger, buf);
 }
 
-void write_prop_inst_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
-    write_int<record_type::PROPATTR>(logger, stream, PROP_INST_NAME);
-    write_name<record_type::PROPVALUE>(logger, stream, name);
+void write_prop_inst_name(spdlog::logger &logger, write_buffer &buf, const std::string &name) {
+    write_int<record_type::PROPATTR>(logger, buf, PROP_INST_NAME);
+    write_name<record_type::PROPVALUE>(logger, buf, name);
 }
 
-void write_polygon(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose,
+void write_polygon(spdlog::logger &logger, write_buffer &buf, glay_t layer, gpurp_t purpose,
                    const layout::polygon &poly) {
-    write_empty<record_type::BOUNDARY>(logger, stream);
-    write_int<record_type::LAYER>(logger, stream, layer);
-    write_int<record_type::DATATYPE>(logger, stream, purpose);
-    write_points(logger, stream, poly.size(), poly.begin(), poly.end());
-    write_element_end(logger, stream);
+    write_empty<record_type::BOUNDARY>(logger, buf);
+    write_int<record_type::LAYER>(logger, buf, layer);
+    write_int<record_type::DATATYPE>(logger, buf, purpose);
+    write_points(logger, buf, poly);
+    write_element_end(logger, buf);
 }
 
-void write_box(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose,
+void write_box(spdlog::logger &logger, write_buffer &buf, glay_t layer, gpurp_t purpose,
                const box_t &b) {
-    write_empty<record_type::BOX>(logger, stream);
-    write_int<record_type::LAYER>(logger, stream, layer);
-    write_int<record_type::BOXTYPE>(logger, stream, purpose);
-
-    auto x0 = interpret_as<uint32_t>(xl(b));
-    auto x1 = interpret_as<uint32_t>(xh(b));
-    auto y0 = interpret_as<uint32_t>(yl(b));
-    auto y1 = interpret_as<uint32_t>(yh(b));
-    std::array<uint32_t, 10> xy{x0, y0, x1, y0, x1, y1, x0, y1, x0, y0};
-    write<record_type::XY>(stream, xy.size(), xy.begin(), xy.end());
-    write_element_end(logger, stream);
+    write_empty<record_type::BOX>(logger, buf);
+    write_int<record_type::LAYER>(logger, buf, layer);
+    write_int<record_type::BOXTYPE>(logger, buf, purpose);
+
+    auto x0 = xl(b);
+    auto x1 = xh(b);
+    auto y0 = yl(b);
+    auto y1 = yh(b);
+    std::array<int32_t, 10> xy{x0, y0, x1, y0, x1, y1, x0, y1, x0, y0};
+    write<record_type::XY>(buf, xy);
+    write_element_end(logger, buf);
 }
 
-void write_arr_instance(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
+void write_arr_instance(spdlog::logger &logger, write_buffer &buf, const std::string &cell_name,
                         const std::string &inst_name, const transformation &xform, cnt_t nx,
                         cnt_t ny, offset_t spx, offset_t spy) {
-    write_empty<record_type::AREF>(logger, stream);
-    write_name<record_type::SNAME>(logger, stream, cell_name);
-    write_transform(logger, stream, xform, 1.0, nx, ny, spx, spy);
-    write_prop_inst_name(logger, stream, inst_name);
-    write_element_end(logger, stream);
+    write_empty<record_type::AREF>(logger, buf);
+    write_name<record_type::SNAME>(logger, buf, cell_name);
+    write_transform(logger, buf, xform, 1.0, nx, ny, spx, spy);
+    write_prop_inst_name(logger, buf, inst_name);
+    write_element_end(logger, buf);
 }
 
-void write_instance(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
+void write_instance(spdlog::logger &logger, write_buffer &buf, const std::string &cell_name,
                     const std::string &inst_name, const transformation &xform, cnt_t nx, cnt_t ny,
                     offset_t spx, offset_t spy) {
     if (nx > 1 || ny > 1) {
-        write_arr_instance(logger, stream, cell_name, inst_name, xform, nx, ny, spx, spy);
+        write_arr_instance(logger, buf, cell_name, inst_name, xform, nx, ny, spx, spy);
     } else {
-        write_empty<record_type::SREF>(logger, stream);
-        write_name<record_type::SNAME>(logger, stream, cell_name);
-        write_transform(logger, stream, xform);
-        write_prop_inst_name(logger, stream, inst_name);
-        write_element_end(logger, stream);
+        write_empty<record_type::SREF>(logger, buf);
+        write_name<record_type::SNAME>(logger, buf, cell_name);
+        write_transform(logger, buf, xform);
+        write_prop_inst_name(logger, buf, inst_name);
+        write_element_end(logger, buf);
     }
 }
 
+void write_text(spdlog::logger &logger, write_buffer &buf, glay_t layer, gpurp_t purpose,
+                const std::string &text, const transformation &xform, offset_t height,
+                double resolution) {
+    write_empty<record_type::TEXT>(logger, buf);
+    write_int<record_type::LAYER>(logger, buf, layer);
+    write_int<record_type::TEXTTYPE>(logger, buf, purpose);
+    write_int<record_type::PRESENTATION>(logger, buf, TEXT_PRESENTATION);
+    write_transform(logger, buf, xform, height * resolution);
+    write_name<record_type::STRING>(logger, buf, text);
+    write_element_end(logger, buf);
+}
+
+// std::ostream versions write one record through a temporary buffer.
+
+void write_header(spdlog::logger &logger, std::ostream &stream) {
+    write_buffer buf(stream);
+    write_header(logger, buf);
+}
+
+void write_units(spdlog::logger &logger, std::ostream &stream, double resolution,
+                 double user_unit) {
+    write_buffer buf(stream);
+    write_units(logger, buf, resolution, user_unit);
+}
+
+void write_lib_begin(spdlog::logger &logger, std::ostream &stream,
+                     const std::vector<tval_t> &time_vec) {
+    write_buffer buf(stream);
+    write_lib_begin(logger, buf, time_vec);
+}
+
+void write_lib_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
+    write_buffer buf(stream);
+    write_lib_name(logger, buf, name);
+}
+
+void write_lib_end(spdlog::logger &logger, std::ostream &stream) {
+    write_buffer buf(stream);
+    write_lib_end(logger, buf);
+}
+
+void write_struct_begin(spdlog::logger &logger, std::ostream &stream,
+                        const std::vector<tval_t> &time_vec) {
+    write_buffer buf(stream);
+    write_struct_begin(logger, buf, time_vec);
+}
+
+void write_struct_name(spdlog::logger &logger, std::ostream &stream, const std::string &name) {
+    write_buffer buf(stream);
+    write_struct_name(logger, buf, name);
+}
+
+void write_struct_end(spdlog::logger &logger, std::ostream &stream) {
+    write_buffer buf(stream);
+    write_struct_end(logger, buf);
+}
+
+void write_transform(spdlog::logger &logger, std::ostream &stream, const transformation &xform,
+                     double mag, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy) {
+    write_buffer buf(stream);
+    write_transform(logger, buf, xform, mag, nx, ny, spx, spy);
+}
+
+void write_polygon(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose,
+                   const layout::polygon &poly) {
+    write_buffer buf(stream);
+    write_polygon(logger, buf, layer, purpose, poly);
+}
+
+void write_box(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose,
+               const box_t &box) {
+    write_buffer buf(stream);
+    write_box(logger, buf, layer, purpose, box);
+}
+
+void write_instance(spdlog::logger &logger, std::ostream &stream, const std::string &cell_name,
+                    const std::string &inst_name, const transformation &xform, cnt_t nx,
+                    cnt_t ny, offset_t spx, offset_t spy) {
+    write_buffer buf(stream);
+    write_instance(logger, buf, cell_name, inst_name, xform, nx, ny, spx, spy);
+}
+
 void write_text(spdlog::logger &logger, std::ostream &stream, glay_t layer, gpurp_t purpose,
                 const std::string &text, const transformation &xform, offset_t height,
                 double resolution) {
-    write_empty<record_type::TEXT>(logger, stream);
-    write_int<record_type::LAYER>(logger, stream, layer);
-    write_int<record_type::TEXTTYPE>(logger, stream, purpose);
-    write_int<record_type::PRESENTATION>(logger, stream, TEXT_PRESENTATION);
-    write_transform(logger, stream, xform, height * resolution);
-    write_name<record_type::STRING>(logger, stream, text);
-    write_element_end(logger, stream);
+    write_buffer buf(stream);
+    write_text(logger, buf, layer, purpose, text, xform, height, resolution);
 }
 
 } // namespace gdsii
@@ -0,0 +1,29 @@
+#include <cbag/common/box_t_util.h>
+#include <cbag/layout/box_array.h>
+
+namespace cbag {
+namespace layout {
+
+box_array::box_array() = default;
+
+box_array::box_array(box_t base, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy)
+    : base(std::move(base)), nx(nx), ny(ny), spx(spx), spy(spy) {}
+
+bool box_array::operator==(const box_array &rhs) const noexcept {
+    return base == rhs.base && nx == rhs.nx && ny == rhs.ny && spx == rhs.spx && spy == rhs.spy;
+}
+
+bool box_array::empty() const noexcept { return nx <= 0 || ny <= 0 || !is_physical(base); }
+
+box_t box_array::get_box(cnt_t ix, cnt_t iy) const {
+    return get_move_by(base, ix * spx, iy * spy);
+}
+
+box_t box_array::get_bbox() const {
+    if (empty())
+        return box_t::get_invalid_box();
+    return get_merge(base, get_box(nx - 1, ny - 1));
+}
+
+} // namespace layout
+} // namespace cbag
@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <memory>
 #include <tuple>
+#include <unordered_set>
+#include <variant>
 
 #include <cbag/util/binary_iterator.h>
+#include <cbag/util/overload.h>
 
+#include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation_util.h>
 #include <cbag/layout/cellview.h>
 #include <cbag/layout/grid_object.h>
@@ -13,53 +19,98 @@
 namespace cbag {
 namespace layout {
 
-class poly45_writer {
-  public:
-    using value_type = polygon45;
-
-  private:
-    geo_index &index;
-    const routing_grid &grid;
-    layer_t key;
-    level_t lev;
-    value_type last;
-    bool has_value = false;
-
-  public:
-    poly45_writer(geo_index &index, const routing_grid &grid, layer_t key, level_t lev)
-        : index(index), grid(grid), key(key), lev(lev) {}
-
-    void push_back(value_type &&v) {
-        record_last();
-        last = std::move(v);
-        has_value = true;
+struct cellview::helper {
+    // tags used to distinguish object types in the content hash.
+    // NOTE: shapes are not hashed as they are added, since the same region can be drawn in
+    // many ways; each layer contributes the hash of its merged region instead.
+    enum hash_tag : enum_t {
+        HASH_LAYER = 0,
+        HASH_INST = 1,
+        HASH_VIA = 2,
+        HASH_PIN = 3,
+        HASH_LABEL = 4,
+        HASH_BLOCKAGE = 5,
+        HASH_BOUNDARY = 6,
+        HASH_VIA_ARR = 7,
+    };
+
+    static void hash_xform(util::hasher128 &h, const transformation &xform) {
+        auto loc = location(xform);
+        h.add(loc[0]).add(loc[1]).add(orient_code(xform));
     }
 
-    void insert(value_type *ptr, const value_type &v) {
-        record_last();
-        last = v;
-        has_value = true;
+    template <typename T> static void hash_points(util::hasher128 &h, const T &poly) {
+        for (auto iter = poly.begin(), stop = poly.end(); iter != stop; ++iter) {
+            auto pt = *iter;
+            h.add(pt.x()).add(pt.y());
+        }
     }
 
-    void record_last() const {
-        if (has_value) {
-            auto [spx, spy] = get_margins(grid, key, lev, last);
-            index.insert(last, spx, spy);
+    static void hash_value(util::hasher128 &h, const value_t &val) {
+        h.add(val.index());
+        std::visit(overload{
+                       [&h](const std::string &v) { h.add(v); },
+                       [&h](const time_struct &v) { h.add(v.time_val); },
+                       [&h](const binary_t &v) { h.add(v.name).add(v.bin_val); },
+                       [&h](auto v) { h.add(v); },
+                   },
+                   val);
+    }
+
+    static void record_inst(cellview &self, const std::string &inst_name, const instance &inst) {
+        util::hasher128 h;
+        h.add(HASH_INST).add(inst_name);
+        auto master = inst.get_cellview();
+        if (master == nullptr) {
+            h.add(inst.get_lib_name("")).add(inst.get_cell_name(nullptr));
+            h.add(inst.get_view_name(""));
+            auto params = inst.get_params();
+            h.add(params->size());
+            for (const auto &[name, val] : *params) {
+                h.add(name);
+                hash_value(h, val);
+            }
+        } else {
+            auto master_hash = master->get_content_hash();
+            h.add(master->get_name()).add(master_hash.lo).add(master_hash.hi);
         }
+        hash_xform(h, inst.xform);
+        h.add(inst.nx).add(inst.ny).add(inst.spx).add(inst.spy);
+        self.content_hash += h.get();
     }
 
-    value_type &back() { return last; }
+    static void hash_via(util::hasher128 &h, const via &v) {
+        h.add(v.get_via_id());
+        hash_xform(h, v.xform);
+        auto &params = v.get_params();
+        h.add(params.num[0]).add(params.num[1]);
+        for (const auto &vec : {params.cut_dim, params.cut_spacing, params.enc[0], params.enc[1],
+                                params.off[0], params.off[1]}) {
+            h.add(vec[0]).add(vec[1]);
+        }
+    }
 
-    value_type *end() const { return nullptr; }
-};
+    static void record_via(cellview &self, const via &v) {
+        util::hasher128 h;
+        h.add(HASH_VIA);
+        hash_via(h, v);
+        self.content_hash += h.get();
+    }
 
-struct cellview::helper {
-    static void add_inst(cellview &self, const instance &inst) {
+    static void record_boundary(cellview &self, const boundary &obj) {
+        util::hasher128 h;
+        h.add(HASH_BOUNDARY).add(obj.get_type());
+        hash_points(h, obj);
+        self.content_hash += h.get();
+    }
+
+    static const std::string &add_inst(cellview &self, const instance &inst) {
         auto &inst_name = inst.get_inst_name();
         if (!inst_name.empty()) {
             // test if given name is valid
-            if (self.inst_map.emplace(inst_name, inst).second)
-                return;
+            auto emp_iter = self.inst_map.emplace(inst_name, inst);
+            if (emp_iter.second)
+                return emp_iter.first->first;
         }
         auto map_end = self.inst_map.end();
         cbag::util::binary_iterator<cnt_t> iter(self.inst_name_cnt);
@@ -73,7 +124,32 @@ struct cellview::helper {
         }
 
         self.inst_name_cnt = *(iter.get_save());
-        self.inst_map.emplace("X" + std::to_string(self.inst_name_cnt), inst);
+        return self.inst_map.emplace("X" + std::to_string(self.inst_name_cnt), inst).first->first;
+    }
+
+    static void add_shape_arr(cellview &self, layer_t key, const box_array &obj) {
+        if (obj.empty())
+            return;
+        if (obj.nx == 1 && obj.ny == 1) {
+            add_shape(self, key, obj.base);
+            return;
+        }
+
+        self.bbox_cache.erase(key);
+        auto &geo = make_geometry(self, key);
+        geo.add_shape(obj);
+
+        // index the whole array as a single instance of a one-rectangle index
+        auto lev_opt = self.get_tech()->get_level(key);
+        if (lev_opt) {
+            auto &grid = *self.get_grid();
+            auto [spx, spy] = get_margins(grid, key, *lev_opt, obj.base);
+            auto master = std::make_shared<geo_index>();
+            master->insert(obj.base, spx, spy);
+            get_geo_index(self, *lev_opt)
+                .insert(master.get(), make_xform(), obj.nx, obj.ny, obj.spx, obj.spy);
+            self.arr_index_list.emplace_back(std::move(master));
+        }
     }
 
     static geometry &make_geometry(cellview &self, layer_t key) {
@@ -88,7 +164,33 @@ struct cellview::helper {
         return self.index_list[lev - self.get_grid()->get_bot_level()];
     }
 
+    static void build_occupancy(const cellview &self, level_t lev) {
+        auto &grid = *self.get_grid();
+        std::unordered_set<const geo_index *> arr_set;
+        for (const auto &ptr : self.arr_index_list) {
+            arr_set.insert(ptr.get());
+        }
+
+        self.occupancy.clear(lev);
+        self.get_geo_index(lev).for_each_object([&self, &grid, &arr_set,
+                                                 lev](const geo_object &obj) {
+            auto inst = obj.get_instance();
+            if (inst == nullptr) {
+                self.occupancy.add(grid, lev, get_expand(obj.get_bbox(), obj.spx, obj.spy));
+            } else if (arr_set.find(inst->get_master()) != arr_set.end()) {
+                // rectangle array; the master bounding box is the expanded base rectangle
+                auto base = inst->get_master()->get_bbox();
+                for (cnt_t ix = 0; ix < inst->get_nx(); ++ix) {
+                    for (cnt_t iy = 0; iy < inst->get_ny(); ++iy) {
+                        self.occupancy.add(grid, lev, get_transform(base, inst->get_xform(ix, iy)));
+                    }
+                }
+            }
+        });
+    }
+
     template <typename T> static void add_shape(cellview &self, layer_t key, const T &obj) {
+        self.bbox_cache.erase(key);
         auto &geo = make_geometry(self, key);
         geo.add_shape(obj);
 
@@ -97,9 +199,12 @@ struct cellview::helper {
             auto &grid = *self.get_grid();
             auto &index = get_geo_index(self, *lev_opt);
             if constexpr (std::is_base_of_v<polygon45_set, std::decay_t<T>>) {
-                poly45_writer writer(index, grid, key, *lev_opt);
-                obj.get(writer);
-                writer.record_last();
+                std::vector<polygon45> poly_list;
+                obj.get(poly_list);
+                for (const auto &poly : poly_list) {
+                    auto [spx, spy] = get_margins(grid, key, *lev_opt, poly);
+                    index.insert(poly, spx, spy);
+                }
             } else {
                 auto [spx, spy] = get_margins(grid, key, *lev_opt, obj);
                 index.insert(obj, spx, spy);
@@ -110,22 +215,49 @@ struct cellview::helper {
 
 cellview::cellview(const routing_grid *grid_ptr, std::string cell_name, geometry_mode geo_mode)
     : geo_mode(geo_mode), grid_ptr(grid_ptr), cell_name(std::move(cell_name)),
-      index_list(grid_ptr->get_num_levels()) {}
+      index_list(grid_ptr->get_num_levels()),
+      occupancy(grid_ptr->get_bot_level(), grid_ptr->get_num_levels()),
+      occ_size_list(grid_ptr->get_num_levels(), 0) {}
 
 bool cellview::operator==(const cellview &rhs) const noexcept {
-    return geo_mode == rhs.geo_mode && *grid_ptr == *(rhs.grid_ptr) && cell_name == rhs.cell_name &&
-           geo_map == rhs.geo_map && inst_map == rhs.inst_map && pin_map == rhs.pin_map &&
-           via_list == rhs.via_list && lay_block_map == rhs.lay_block_map &&
-           area_block_list == rhs.area_block_list && boundary_list == rhs.boundary_list &&
-           label_list == rhs.label_list;
+    return cell_name == rhs.cell_name && content_equal(rhs);
 }
 
+bool cellview::content_equal(const cellview &rhs) const noexcept {
+    return geo_mode == rhs.geo_mode &&
+           (grid_ptr == rhs.grid_ptr || *grid_ptr == *(rhs.grid_ptr)) &&
+           get_content_hash() == rhs.get_content_hash();
+}
+
+util::hash128 cellview::get_content_hash() const {
+    auto ans = content_hash;
+    for (const auto &[key, geo] : geo_map) {
+        auto region = geo.get_region_hash();
+        util::hasher128 h;
+        h.add(helper::HASH_LAYER).add(key.first).add(key.second).add(region.lo).add(region.hi);
+        ans += h.get();
+    }
+    return ans;
+}
+
+std::size_t cellview::get_hash() const { return get_content_hash().get_hash(); }
+
 void cellview::set_geometry_mode(geometry_mode new_mode) {
     if (!empty())
         throw std::runtime_error("Cannot change geometry mode of non-empty layout.");
     geo_mode = new_mode;
 }
 
+bool cellview::is_bulk_mode() const noexcept {
+    return !index_list.empty() && index_list.front().is_bulk_mode();
+}
+
+void cellview::set_bulk_mode(bool val) {
+    for (auto &index : index_list) {
+        index.set_bulk_mode(val);
+    }
+}
+
 auto cellview::find_geometry(layer_t key) const -> decltype(geo_map.find(key)) {
     return geo_map.find(key);
 }
@@ -135,20 +267,59 @@ const tech *cellview::get_tech() const noexcept { return grid_ptr->get_tech(); }
 const routing_grid *cellview::get_grid() const noexcept { return grid_ptr; }
 
 bool cellview::empty() const noexcept {
-    return geo_map.empty() && inst_map.empty() && via_list.empty() && lay_block_map.empty() &&
-           area_block_list.empty() && boundary_list.empty() && pin_map.empty();
+    return geo_map.empty() && inst_map.empty() && via_list.empty() && via_arr_list.empty() &&
+           lay_block_map.empty() && area_block_list.empty() && boundary_list.empty() &&
+           pin_map.empty();
+}
+
+box_t cellview::get_bbox(layer_t key) const {
+    auto iter = bbox_cache.find(key);
+    if (iter != bbox_cache.end())
+        return iter->second;
+
+    auto ans = box_t::get_invalid_box();
+    // merge geometry bounding box
+    auto geo_iter = geo_map.find(key);
+    if (geo_iter != geo_map.end()) {
+        merge(ans, geo_iter->second.get_bbox());
+    }
+    // merge instance bounding box; masters reuse their own cache
+    for (const auto &[name, inst] : inst_map) {
+        merge(ans, inst.get_bbox(key));
+    }
+    bbox_cache.emplace(key, ans);
+    return ans;
 }
 
 const geo_index &cellview::get_geo_index(level_t lev) const {
     return index_list[lev - get_grid()->get_bot_level()];
 }
 
+const track_occupancy &cellview::get_track_occupancy() const {
+    // objects are never removed, so a level is stale if and only if its index grew
+    auto bot_lev = get_grid()->get_bot_level();
+    for (std::size_t idx = 0; idx < index_list.size(); ++idx) {
+        auto cur_size = index_list[idx].size();
+        if (cur_size != occ_size_list[idx]) {
+            helper::build_occupancy(*this, bot_lev + static_cast<level_t>(idx));
+            occ_size_list[idx] = cur_size;
+        }
+    }
+    return occupancy;
+}
+
 auto cellview::begin_inst() const -> decltype(inst_map.cbegin()) { return inst_map.cbegin(); }
 auto cellview::end_inst() const -> decltype(inst_map.cend()) { return inst_map.cend(); }
 auto cellview::begin_geometry() const -> decltype(geo_map.cbegin()) { return geo_map.cbegin(); }
 auto cellview::end_geometry() const -> decltype(geo_map.cend()) { return geo_map.cend(); }
 auto cellview::begin_via() const -> decltype(via_list.cbegin()) { return via_list.cbegin(); }
 auto cellview::end_via() const -> decltype(via_list.cend()) { return via_list.cend(); }
+auto cellview::begin_via_arr() const -> decltype(via_arr_list.cbegin()) {
+    return via_arr_list.cbegin();
+}
+auto cellview::end_via_arr() const -> decltype(via_arr_list.cend()) {
+    return via_arr_list.cend();
+}
 auto cellview::begin_lay_block() const -> decltype(lay_block_map.cbegin()) {
     return lay_block_map.cbegin();
 }
@@ -177,15 +348,27 @@ void cellview::add_pin(lay_t lay_id, std::string &&net, std::string &&label, box
     if (iter == pin_map.end()) {
         iter = pin_map.emplace(lay_id, std::vector<pin>()).first;
     }
+    util::hasher128 h;
+    h.add(helper::HASH_PIN).add(lay_id).add(net).add(label);
+    h.add(xl(bbox)).add(yl(bbox)).add(xh(bbox)).add(yh(bbox));
+    content_hash += h.get();
     iter->second.emplace_back(std::move(bbox), std::move(net), std::move(label));
 }
 
 void cellview::add_label(layer_t &&key, transformation &&xform, std::string &&label,
                          offset_t height) {
+    util::hasher128 h;
+    h.add(helper::HASH_LABEL).add(key.first).add(key.second).add(label).add(height);
+    helper::hash_xform(h, xform);
+    content_hash += h.get();
     label_list.emplace_back(std::move(key), std::move(xform), std::move(label), height);
 }
 
 void cellview::add_object(const blockage &obj) {
+    util::hasher128 h;
+    h.add(helper::HASH_BLOCKAGE).add(obj.get_type()).add(obj.get_layer());
+    helper::hash_points(h, obj);
+    content_hash += h.get();
     if (obj.get_type() == blockage_type::placement) {
         // area blockage
         area_block_list.push_back(obj);
@@ -199,14 +382,23 @@ void cellview::add_object(const blockage &obj) {
     }
 }
 
-void cellview::add_object(const boundary &obj) { boundary_list.push_back(obj); }
+void cellview::add_object(const boundary &obj) {
+    helper::record_boundary(*this, obj);
+    boundary_list.push_back(obj);
+}
 
-void cellview::add_object(boundary &&obj) { boundary_list.push_back(std::move(obj)); }
+void cellview::add_object(boundary &&obj) {
+    helper::record_boundary(*this, obj);
+    boundary_list.push_back(std::move(obj));
+}
 
 void cellview::add_object(const via_wrapper &obj) {
+    if (obj.v.get_via_def() == invalid_via_def)
+        throw std::invalid_argument("Cannot add a via with no via definition.");
+    helper::record_via(*this, obj.v);
     via_list.push_back(obj.v);
     if (obj.add_layers) {
-        auto [bot_key, unused, top_key] = get_tech()->get_via_layer_purpose(obj.v.get_via_id());
+        auto [bot_key, unused, top_key] = get_tech()->get_via_layer_purpose(obj.v.get_via_def());
         (void)unused;
         auto bot_box = get_bot_box(obj.v);
         auto top_box = get_top_box(obj.v);
@@ -216,29 +408,25 @@ void cellview::add_object(const via_wrapper &obj) {
 }
 
 void cellview::add_object(const instance &obj) {
-    helper::add_inst(*this, obj);
+    auto &inst_name = helper::add_inst(*this, obj);
+    helper::record_inst(*this, inst_name, obj);
+    bbox_cache.clear();
     auto master = obj.get_cellview();
     if (master != nullptr) {
         // NOTE: all routing_grids are guaranteed to have the same levels.
         auto &grid = *get_grid();
-        transformation xform_copy(obj.xform);
-        auto tot_dx = obj.spx * obj.nx;
-        auto tot_dy = obj.spy * obj.ny;
         for (auto cur_lev = grid.get_bot_level(); cur_lev <= grid.get_top_level(); ++cur_lev) {
             auto &parent_index = helper::get_geo_index(*this, cur_lev);
             auto &inst_index = master->get_geo_index(cur_lev);
-            for (decltype(obj.nx) ix = 0; ix < obj.nx; ++ix, move_by(xform_copy, obj.spx, 0)) {
-                for (decltype(obj.ny) iy = 0; iy < obj.ny; ++iy, move_by(xform_copy, 0, obj.spy)) {
-                    parent_index.insert(&inst_index, xform_copy);
-                }
-                move_by(xform_copy, 0, -tot_dy);
-            }
-            move_by(xform_copy, -tot_dx, 0);
+            parent_index.insert(&inst_index, obj.xform, obj.nx, obj.ny, obj.spx, obj.spy);
         }
     }
 }
 
 void cellview::add_shape(layer_t key, const box_t &obj) { helper::add_shape(*this, key, obj); }
+void cellview::add_shape(layer_t key, const box_array &obj) {
+    helper::add_shape_arr(*this, key, obj);
+}
 void cellview::add_shape(layer_t key, const polygon90 &obj) { helper::add_shape(*this, key, obj); }
 void cellview::add_shape(layer_t key, const polygon45 &obj) { helper::add_shape(*this, key, obj); }
 void cellview::add_shape(layer_t key, const polygon &obj) { helper::add_shape(*this, key, obj); }
@@ -253,6 +441,7 @@ void cellview::add_warr(const track_id &tid, std::array<offset_t, 2> coord) {
     for (auto iter = begin_rect(grid, tid, coord), stop = end_rect(grid, tid, coord); iter != stop;
          ++iter) {
         auto [key, box] = *iter;
+        bbox_cache.erase(key);
         auto &geo = helper::make_geometry(*this, key);
         geo.add_shape(box);
 
@@ -261,5 +450,92 @@ void cellview::add_warr(const track_id &tid, std::array<offset_t, 2> coord) {
     }
 }
 
+void cellview::add_warrs(const std::vector<wire_array> &warr_list, std::size_t num_rect_hint) {
+    if (warr_list.empty())
+        return;
+
+    auto &grid = *get_grid();
+    std::vector<std::tuple<layer_t, level_t, box_t>> rect_list;
+    rect_list.reserve((num_rect_hint == 0) ? warr_list.size() : num_rect_hint);
+    for (const auto &warr : warr_list) {
+        auto &tid = warr.get_track_id_ref();
+        auto lev = tid.get_level();
+        for (auto iter = begin_rect(grid, tid, warr.get_coord()),
+                  stop = end_rect(grid, tid, warr.get_coord());
+             iter != stop; ++iter) {
+            auto [key, box] = *iter;
+            rect_list.emplace_back(key, lev, box);
+        }
+    }
+    // stable sort keeps the per-layer order of add_warr()
+    std::stable_sort(rect_list.begin(), rect_list.end(),
+                     [](const auto &lhs, const auto &rhs) {
+                         return std::get<0>(lhs) < std::get<0>(rhs);
+                     });
+
+    // add to geometries, one layer at a time
+    std::vector<box_t> box_list;
+    for (auto start = rect_list.begin(), stop = rect_list.end(); start != stop;) {
+        auto &key = std::get<0>(*start);
+        box_list.clear();
+        auto cur = start;
+        for (; cur != stop && std::get<0>(*cur) == key; ++cur) {
+            auto &box = std::get<2>(*cur);
+            box_list.push_back(box);
+        }
+        bbox_cache.erase(key);
+        helper::make_geometry(*this, key).add_shapes(box_list);
+        start = cur;
+    }
+
+    // buffer index insertions, so each index is built once
+    std::vector<std::size_t> cnt_list(index_list.size(), 0);
+    auto bot_lev = grid.get_bot_level();
+    for (const auto &rect : rect_list) {
+        ++cnt_list[std::get<1>(rect) - bot_lev];
+    }
+    std::vector<bool> restore_list(index_list.size(), false);
+    for (std::size_t idx = 0; idx < index_list.size(); ++idx) {
+        if (cnt_list[idx] > 0 && !index_list[idx].is_bulk_mode()) {
+            index_list[idx].set_bulk_mode(true);
+            index_list[idx].reserve(cnt_list[idx]);
+            restore_list[idx] = true;
+        }
+    }
+    for (const auto &[key, lev, box] : rect_list) {
+        auto [spx, spy] = get_margins(grid, key, lev, box);
+        helper::get_geo_index(*this, lev).insert(box, spx, spy);
+    }
+    for (std::size_t idx = 0; idx < index_list.size(); ++idx) {
+        if (restore_list[idx])
+            index_list[idx].set_bulk_mode(false);
+    }
+}
+
+void cellview::add_via_arr(const via_array &obj, bool add_layers) {
+    if (obj.nx <= 0 || obj.ny <= 0)
+        return;
+    if (obj.nx == 1 && obj.ny == 1) {
+        add_object(via_wrapper(via(obj.base), add_layers));
+        return;
+    }
+    if (obj.base.get_via_def() == invalid_via_def)
+        throw std::invalid_argument("Cannot add a via with no via definition.");
+
+    util::hasher128 h;
+    h.add(helper::HASH_VIA_ARR);
+    helper::hash_via(h, obj.base);
+    h.add(obj.nx).add(obj.ny).add(obj.spx).add(obj.spy).add(via_list.size());
+    content_hash += h.get();
+    via_arr_list.push_back(obj);
+    via_arr_pos_list.push_back(via_list.size());
+    if (add_layers) {
+        auto [bot_key, unused, top_key] = get_tech()->get_via_layer_purpose(obj.base.get_via_def());
+        (void)unused;
+        add_shape(bot_key, box_array(get_bot_box(obj.base), obj.nx, obj.ny, obj.spx, obj.spy));
+        add_shape(top_key, box_array(get_top_box(obj.base), obj.nx, obj.ny, obj.spx, obj.spy));
+    }
+}
+
 } // namespace layout
 } // namespace cbag
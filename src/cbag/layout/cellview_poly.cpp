@@ -16,14 +16,7 @@ shape_ref<box_t> add_rect(cellview &cv, const std::string &layer, const std::str
 
 void add_rect_arr(cellview &cv, layer_t &key, const box_t &box, std::array<cnt_t, 2> num,
                   std::array<offset_t, 2> sp) {
-    box_t box_copy(box);
-    for (cnt_t xidx = 0; xidx < num[0]; ++xidx, move_by(box_copy, sp[0], 0)) {
-        auto tot_dy = num[1] * sp[1];
-        for (cnt_t yidx = 0; yidx < num[1]; ++yidx, move_by(box_copy, 0, sp[1])) {
-            cv.add_shape(key, box_copy);
-        }
-        move_by(box_copy, 0, -tot_dy);
-    }
+    cv.add_shape(key, box_array(box, num[0], num[1], sp[0], sp[1]));
 }
 
 void add_rect_arr(cellview &cv, const std::string &layer, const std::string &purpose,
@@ -1,5 +1,7 @@
 #include <cstdlib>
 
+#include <cbag/util/parallel.h>
+
 #include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation_util.h>
 #include <cbag/layout/cellview_poly.h>
@@ -16,17 +18,16 @@ namespace cbag {
 namespace layout {
 
 box_t get_bbox(const cellview &cv, const std::string &layer, const std::string &purpose) {
-    auto ans = box_t::get_invalid_box();
-    // merge geometry bounding box
-    auto iter = cv.find_geometry(layer_t_at(*cv.get_tech(), layer, purpose));
-    if (iter != cv.end_geometry()) {
-        merge(ans, iter->second.get_bbox());
-    }
-    // merge instance bounding box
-    for (auto it = cv.begin_inst(); it != cv.end_inst(); ++it) {
-        merge(ans, it->second.get_bbox(layer, purpose));
+    return cv.get_bbox(layer_t_at(*cv.get_tech(), layer, purpose));
+}
+
+void merge_geometry(const cellview &cv, std::size_t num_workers) {
+    std::vector<const geometry *> geo_list;
+    for (auto iter = cv.begin_geometry(); iter != cv.end_geometry(); ++iter) {
+        geo_list.push_back(&(iter->second));
     }
-    return ans;
+    util::parallel_for(geo_list.size(), num_workers,
+                       [&geo_list](std::size_t idx) { geo_list[idx]->merge(); });
 }
 
 void add_pin(cellview &cv, const std::string &layer, const std::string &net,
@@ -64,19 +65,21 @@ void add_pin_arr(cellview &cv, const std::string &net, const std::string &label,
 
 cv_obj_ref<via_wrapper> add_via(cellview &cv, transformation xform, std::string via_id,
                                 const via_param &params, bool add_layers, bool commit) {
-    return {&cv, via_wrapper(via(std::move(xform), std::move(via_id), params), add_layers), commit};
+    return {&cv, via_wrapper(via(std::move(xform), via_id, params), add_layers), commit};
+}
+
+void add_via_arr(cellview &cv, const transformation &xform, via_def_t vdef,
+                 const via_param &params, bool add_layers, std::array<cnt_t, 2> num_arr,
+                 std::array<offset_t, 2> sp_arr) {
+    cv.add_via_arr(
+        via_array(via(xform, vdef, params), num_arr[0], num_arr[1], sp_arr[0], sp_arr[1]),
+        add_layers);
 }
 
 void add_via_arr(cellview &cv, const transformation &xform, const std::string &via_id,
                  const via_param &params, bool add_layers, std::array<cnt_t, 2> num_arr,
                  std::array<offset_t, 2> sp_arr) {
-    offset_t dx = 0;
-    for (cnt_t xidx = 0; xidx < num_arr[0]; ++xidx, dx += sp_arr[0]) {
-        offset_t dy = 0;
-        for (cnt_t yidx = 0; yidx < num_arr[1]; ++yidx, dy += sp_arr[1]) {
-            cv.add_object(via_wrapper(via(get_move_by(xform, dx, dy), via_id, params), add_layers));
-        }
-    }
+    add_via_arr(cv, xform, intern_via_id(via_id), params, add_layers, num_arr, sp_arr);
 }
 
 std::array<std::array<coord_t, 2>, 2> add_via_on_intersections(cellview &cv, const track_id &tid1,
@@ -121,9 +124,9 @@ std::array<std::array<coord_t, 2>, 2> add_via_on_intersections(cellview &cv, con
             auto box_dim = dim(via_box);
             if (box_dim[to_int(dir0)] == get_dim(box1, dir0) &&
                 box_dim[to_int(dir1)] == get_dim(box0, dir1)) {
-                auto &via_id = tech.get_via_id(direction::LOWER, lay0, lay1);
+                auto vdef = tech.get_via_def(direction::LOWER, lay0, lay1);
                 auto via_param =
-                    tech.get_via_param(box_dim, via_id, direction::LOWER, dir0, dir1, extend);
+                    tech.get_via_param(box_dim, vdef, direction::LOWER, dir0, dir1, extend);
                 if (!empty(via_param)) {
                     auto via_ext =
                         get_via_extensions(via_param, box_dim, direction::LOWER, dir0, dir1);
@@ -135,7 +138,7 @@ std::array<std::array<coord_t, 2>, 2> add_via_on_intersections(cellview &cv, con
                                      lower(box1, dir1) <= l1 && upper(box1, dir1) >= u1)) {
                         // we can draw via safely
                         cv.add_object(via_wrapper(
-                            via(make_xform(xm(via_box), ym(via_box)), via_id, via_param), false));
+                            via(make_xform(xm(via_box), ym(via_box)), vdef, via_param), false));
                         // update bounds
                         ans[0][0] = std::min(ans[0][0], l0);
                         ans[0][1] = std::max(ans[0][1], u0);
@@ -187,11 +190,11 @@ connect_box_track(cellview &cv, direction vdir, layer_t key, const box_t &box,
          iter != stop; ++iter) {
         // compute via
         auto [tr_key, tr_box] = *iter;
-        auto &via_id = tech.get_via_id(vdir, key, tr_key);
+        auto vdef = tech.get_via_def(vdir, key, tr_key);
         auto via_box = box_t(tr_dir, box.intvs[tr_didx][0], box.intvs[tr_didx][1],
                              tr_box.intvs[p_didx][0], tr_box.intvs[p_didx][1]);
         auto via_dim = dim(via_box);
-        auto via_param = tech.get_via_param(via_dim, via_id, vdir, p_dir, tr_dir, true);
+        auto via_param = tech.get_via_param(via_dim, vdef, vdir, p_dir, tr_dir, true);
 
         // add via
         auto xform = make_xform(xm(via_box), ym(via_box));
@@ -199,7 +202,7 @@ connect_box_track(cellview &cv, direction vdir, layer_t key, const box_t &box,
         auto via_sp = std::array<offset_t, 2>{0, 0};
         via_num[tr_didx] = num_box;
         via_sp[tr_didx] = sp_box;
-        add_via_arr(cv, xform, via_id, via_param, false, via_num, via_sp);
+        add_via_arr(cv, xform, vdef, via_param, false, via_num, via_sp);
 
         // get via coordinate boundaries
         auto via_ext = get_via_extensions(via_param, via_dim, vdir, p_dir, tr_dir);
@@ -0,0 +1,23 @@
+#include <boost/container_hash/hash.hpp>
+
+#include <cbag/layout/flip_parity_cache.h>
+
+namespace cbag {
+namespace layout {
+
+bool flip_parity_query::operator==(const flip_parity_query &rhs) const noexcept {
+    return bot_level == rhs.bot_level && top_level == rhs.top_level && orient == rhs.orient &&
+           loc == rhs.loc;
+}
+
+std::size_t flip_parity_query_hash::operator()(const flip_parity_query &v) const {
+    auto seed = boost::hash_value(v.bot_level);
+    boost::hash_combine(seed, v.top_level);
+    boost::hash_combine(seed, v.orient);
+    boost::hash_combine(seed, v.loc[0]);
+    boost::hash_combine(seed, v.loc[1]);
+    return seed;
+}
+
+} // namespace layout
+} // namespace cbag
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include <cbag/common/box_t_util.h>
+#include <cbag/common/transformation_util.h>
 #include <cbag/layout/geo_index.h>
 #include <cbag/layout/geo_iterator.h>
 #include <cbag/layout/geometry.h>
@@ -7,11 +10,68 @@
 namespace cbag {
 namespace layout {
 
+struct geo_index::helper {
+    static void build(const geo_index &self) {
+        if (!self.pending.load(std::memory_order_acquire))
+            return;
+        std::lock_guard<std::mutex> lock(self.build_lock);
+        if (!self.pending.load(std::memory_order_relaxed))
+            return;
+
+        if (self.index.empty() || self.buffer.size() >= self.index.size()) {
+            // rebuild the whole tree with the packing algorithm
+            self.buffer.insert(self.buffer.end(), self.index.begin(), self.index.end());
+            self.index = geo_index_impl(self.buffer.begin(), self.buffer.end());
+        } else {
+            // only a few new objects, incremental insertion is cheaper than a rebuild
+            self.index.insert(self.buffer.begin(), self.buffer.end());
+        }
+        self.buffer.clear();
+        self.buffer.shrink_to_fit();
+        self.pending.store(false, std::memory_order_release);
+    }
+};
+
 geo_index::geo_index() = default;
 
-bool geo_index::empty() const { return index.empty(); }
+geo_index::geo_index(const geo_index &other)
+    : index((other.commit(), other.index)), bulk_mode(other.bulk_mode) {}
+
+geo_index::geo_index(geo_index &&other) noexcept
+    : index(std::move(other.index)), buffer(std::move(other.buffer)),
+      pending(other.pending.load()), bulk_mode(other.bulk_mode) {}
+
+geo_index &geo_index::operator=(const geo_index &other) {
+    if (this != &other) {
+        other.commit();
+        index = other.index;
+        buffer.clear();
+        pending = false;
+        bulk_mode = other.bulk_mode;
+    }
+    return *this;
+}
+
+geo_index &geo_index::operator=(geo_index &&other) noexcept {
+    index = std::move(other.index);
+    buffer = std::move(other.buffer);
+    pending = other.pending.load();
+    bulk_mode = other.bulk_mode;
+    return *this;
+}
+
+bool geo_index::empty() const { return size() == 0; }
+
+std::size_t geo_index::size() const {
+    if (pending.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(build_lock);
+        return index.size() + buffer.size();
+    }
+    return index.size();
+}
 
 box_t geo_index::get_bbox() const {
+    helper::build(*this);
     box_t ans;
     auto box = index.bounds();
     set(ans, box.min_corner().get<0>(), box.min_corner().get<1>(), box.max_corner().get<0>(),
@@ -19,21 +79,54 @@ box_t geo_index::get_bbox() const {
     return ans;
 }
 
+bool geo_index::is_bulk_mode() const noexcept { return bulk_mode; }
+
+void geo_index::set_bulk_mode(bool val) {
+    bulk_mode = val;
+    if (!val)
+        helper::build(*this);
+}
+
+void geo_index::reserve(std::size_t n) {
+    if (bulk_mode)
+        buffer.reserve(n);
+}
+
+void geo_index::commit() const { helper::build(*this); }
+
+geo_query_iter geo_index::qbegin(const box_t &r, offset_t spx, offset_t spy) const {
+    helper::build(*this);
+    return index.qbegin(bgi::intersects(
+        bg_box(bg_point(xl(r) - spx, yl(r) - spy), bg_point(xh(r) + spx, yh(r) + spy))));
+}
+
 geo_iterator geo_index::begin_intersect(const box_t &r, offset_t spx, offset_t spy,
                                         const cbag::transformation &xform) const {
+    return {r, spx, spy, qbegin(r, spx, spy), xform};
+}
 
-    return {r,
-            spx,
-            spy,
-            index.qbegin(bgi::intersects(
-                bg_box(bg_point(xl(r) - spx, yl(r) - spy), bg_point(xh(r) + spx, yh(r) + spy)))),
-            index.qend(),
-            xform};
+bool geo_index::visit_intersect_impl(const box_t &r, offset_t spx, offset_t spy,
+                                     const cbag::transformation &xform, visit_fun_t fn,
+                                     void *data) const {
+    for (geo_traversal trav(r, spx, spy, qbegin(r, spx, spy), xform); trav.find_leaf();
+         trav.skip()) {
+        auto &top = trav.top();
+        auto &obj = *top.cur;
+        auto bbox = obj.get_bbox();
+        auto test_box = get_expand(top.box, std::max(top.spx, obj.spx), std::max(top.spy, obj.spy));
+        if (std::max(xl(bbox), xl(test_box)) < std::min(xh(bbox), xh(test_box)) &&
+            std::max(yl(bbox), yl(test_box)) < std::min(yh(bbox), yh(test_box)) &&
+            fn(data, geo_view{obj, static_cast<geo_union_enum>(obj.val.index()), bbox, top.xform,
+                              obj.spx, obj.spy}))
+            return true;
+    }
+    return false;
 }
 
-void geo_index::insert(const geo_index *master, const cbag::transformation &xform) {
-    if (!master->empty())
-        index.insert(geo_object(geo_instance(master, xform), 0, 0));
+void geo_index::insert(const geo_index *master, const cbag::transformation &xform, cnt_t nx,
+                       cnt_t ny, offset_t spx, offset_t spy) {
+    if (!master->empty() && nx > 0 && ny > 0)
+        insert(geo_instance(master, xform, nx, ny, spx, spy), 0, 0);
 }
 
 } // namespace layout
@@ -1,37 +1,75 @@
+#include <algorithm>
+
 #include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation_util.h>
 #include <cbag/layout/geo_index.h>
 #include <cbag/layout/geo_instance.h>
-#include <cbag/layout/geo_iterator.h>
+#include <cbag/util/math.h>
 
 namespace cbag {
 namespace layout {
 
+// returns all idx in [0, n) such that [bl + idx * sp, bh + idx * sp] intersects [ql, qh]
+std::array<cnt_t, 2> get_array_range(int64_t bl, int64_t bh, int64_t ql, int64_t qh, int64_t sp,
+                                     cnt_t n) {
+    if (sp == 0) {
+        return (bl <= qh && bh >= ql) ? std::array<cnt_t, 2>{0, n} : std::array<cnt_t, 2>{0, 0};
+    }
+    if (sp < 0)
+        return get_array_range(-bh, -bl, -qh, -ql, -sp, n);
+
+    auto start = std::max(util::ceil_div(ql - bh, sp), static_cast<int64_t>(0));
+    auto stop = std::min(util::floor_div(qh - bl, sp) + 1, static_cast<int64_t>(n));
+    if (start >= stop)
+        return {0, 0};
+    return {static_cast<cnt_t>(start), static_cast<cnt_t>(stop)};
+}
+
 geo_instance::geo_instance() = default;
 
-geo_instance::geo_instance(const geo_index *master, cbag::transformation xform)
-    : master(master), xform(std::move(xform)) {}
+geo_instance::geo_instance(const geo_index *master, cbag::transformation xform, cnt_t nx, cnt_t ny,
+                           offset_t spx, offset_t spy)
+    : master(master), xform(std::move(xform)), nx(nx), ny(ny), spx(spx), spy(spy) {}
+
+bool geo_instance::empty() const { return master->empty() || nx == 0 || ny == 0; }
+
+const geo_index *geo_instance::get_master() const noexcept { return master; }
 
-bool geo_instance::empty() const { return master->empty(); }
+const transformation &geo_instance::get_xform() const noexcept { return xform; }
+
+transformation geo_instance::get_xform(cnt_t ix, cnt_t iy) const {
+    return get_move_by(xform, static_cast<offset_t>(ix) * spx, static_cast<offset_t>(iy) * spy);
+}
+
+cnt_t geo_instance::get_nx() const noexcept { return nx; }
+
+cnt_t geo_instance::get_ny() const noexcept { return ny; }
 
 box_t geo_instance::get_bbox() const {
     box_t ans = master->get_bbox();
-    return transform(ans, xform);
+    transform(ans, xform);
+    if (nx > 1 || ny > 1) {
+        merge(ans, get_move_by(ans, static_cast<offset_t>(nx - 1) * spx,
+                               static_cast<offset_t>(ny - 1) * spy));
+    }
+    return ans;
 }
 
-geo_iterator geo_instance::begin_intersect(const box_t &r, offset_t spx, offset_t spy) const {
-    auto spx_new = spx;
-    auto spy_new = spy;
-    auto test_r = get_transform(r, get_invert(xform));
-    if (flips_xy(xform)) {
-        spx_new = spy;
-        spy_new = spx;
-    }
-    return master->begin_intersect(test_r, spx_new, spy_new, xform);
+std::array<std::array<cnt_t, 2>, 2> geo_instance::get_index_range(const box_t &r, offset_t spx,
+                                                                  offset_t spy) const {
+    if (nx == 1 && ny == 1)
+        return {std::array<cnt_t, 2>{0, 1}, std::array<cnt_t, 2>{0, 1}};
+
+    auto base = get_transform(master->get_bbox(), xform);
+    return {get_array_range(xl(base), xh(base), static_cast<int64_t>(xl(r)) - spx,
+                            static_cast<int64_t>(xh(r)) + spx, this->spx, nx),
+            get_array_range(yl(base), yh(base), static_cast<int64_t>(yl(r)) - spy,
+                            static_cast<int64_t>(yh(r)) + spy, this->spy, ny)};
 }
 
 bool geo_instance::operator==(const geo_instance &rhs) const {
-    return master == rhs.master && xform == rhs.xform;
+    return master == rhs.master && xform == rhs.xform && nx == rhs.nx && ny == rhs.ny &&
+           spx == rhs.spx && spy == rhs.spy;
 }
 
 } // namespace layout
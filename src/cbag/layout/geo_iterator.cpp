@@ -4,6 +4,8 @@
 
 #include <cbag/common/box_t_adapt.h>
 #include <cbag/common/box_t_util.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/layout/geo_index.h>
 #include <cbag/layout/geo_iterator.h>
 #include <cbag/util/overload.h>
 
@@ -12,6 +14,120 @@ using namespace boost::polygon::operators;
 namespace cbag {
 namespace layout {
 
+struct geo_traversal::helper {
+    // set up the query of the current array element of the frame at the given level
+    static void init_element(geo_traversal &self, std::size_t lev) {
+        auto &parent = self.get_frame(lev - 1);
+        auto &child = self.get_frame(lev);
+        auto inst_xform = child.inst->get_xform(child.idx[0], child.idx[1]);
+        child.box = get_transform(parent.box, get_invert(inst_xform));
+        if (flips_xy(inst_xform)) {
+            child.spx = parent.spy;
+            child.spy = parent.spx;
+        } else {
+            child.spx = parent.spx;
+            child.spy = parent.spy;
+        }
+        child.cur = child.inst->get_master()->qbegin(child.box, child.spx, child.spy);
+        child.xform = get_transform_by(inst_xform, parent.xform);
+    }
+
+    static void push_frame(geo_traversal &self, const geo_instance &inst) {
+        auto &parent = self.get_frame(self.depth - 1);
+        auto [xrange, yrange] = inst.get_index_range(parent.box, parent.spx, parent.spy);
+        if (xrange[0] == xrange[1] || yrange[0] == yrange[1])
+            return;
+
+        // growing the spill storage may move frames, so parent is not used past this point
+        if (self.depth >= inline_depth && self.spill.size() == self.depth - inline_depth)
+            self.spill.emplace_back();
+
+        auto &child = self.get_frame(self.depth);
+        child.inst = &inst;
+        child.start = {xrange[0], yrange[0]};
+        child.stop = {xrange[1], yrange[1]};
+        child.idx = child.start;
+        init_element(self, self.depth);
+        ++self.depth;
+    }
+
+    // move the top frame to its next array element.  Returns false if there are none left.
+    static bool next_element(geo_traversal &self) {
+        auto &top = self.get_frame(self.depth - 1);
+        if (top.inst == nullptr)
+            return false;
+        if (++top.idx[1] == top.stop[1]) {
+            top.idx[1] = top.start[1];
+            if (++top.idx[0] == top.stop[0])
+                return false;
+        }
+        init_element(self, self.depth - 1);
+        return true;
+    }
+};
+
+bool geo_traversal::frame::operator==(const frame &rhs) const {
+    return box == rhs.box && spx == rhs.spx && spy == rhs.spy && cur == rhs.cur &&
+           xform == rhs.xform && inst == rhs.inst && idx == rhs.idx;
+}
+
+geo_traversal::frame &geo_traversal::get_frame(std::size_t lev) {
+    return lev < inline_depth ? stack[lev] : spill[lev - inline_depth];
+}
+
+const geo_traversal::frame &geo_traversal::get_frame(std::size_t lev) const {
+    return lev < inline_depth ? stack[lev] : spill[lev - inline_depth];
+}
+
+geo_traversal::geo_traversal() = default;
+
+geo_traversal::geo_traversal(const box_t &box, offset_t spx, offset_t spy, geo_query_iter &&cur,
+                             const cbag::transformation &xform)
+    : depth(1) {
+    auto &root = stack[0];
+    root.box = box;
+    root.spx = spx;
+    root.spy = spy;
+    root.cur = std::move(cur);
+    root.xform = xform;
+    root.inst = nullptr;
+}
+
+bool geo_traversal::has_next() const { return depth > 0; }
+
+bool geo_traversal::find_leaf() {
+    while (depth > 0) {
+        auto &top = get_frame(depth - 1);
+        if (top.cur == geo_query_iter()) {
+            // this array element is done
+            if (!helper::next_element(*this))
+                --depth;
+            continue;
+        }
+        auto inst_ptr = top.cur->get_instance();
+        if (inst_ptr == nullptr)
+            return true;
+        // descend into the instance; the parent iterator resumes after it
+        ++top.cur;
+        helper::push_frame(*this, *inst_ptr);
+    }
+    return false;
+}
+
+const geo_traversal::frame &geo_traversal::top() const { return get_frame(depth - 1); }
+
+void geo_traversal::skip() { ++get_frame(depth - 1).cur; }
+
+bool geo_traversal::operator==(const geo_traversal &rhs) const {
+    if (depth != rhs.depth)
+        return false;
+    for (std::size_t lev = 0; lev < depth; ++lev) {
+        if (!(get_frame(lev) == rhs.get_frame(lev)))
+            return false;
+    }
+    return true;
+}
+
 struct geo_iterator::helper {
 
     struct xform_visitor {
@@ -26,52 +142,45 @@ struct geo_iterator::helper {
     struct geo_visitor {
       public:
         geo_iterator &self;
+        const geo_traversal::frame &top;
+
+        geo_visitor(geo_iterator &self, const geo_traversal::frame &top) : self(self), top(top) {}
 
-        geo_visitor(geo_iterator &self) : self(self) {}
+        bool operator()(const geo_instance &v) { return false; }
 
-        bool operator()(const geo_instance &v) {
-            self.inner =
-                std::make_shared<geo_iterator>(v.begin_intersect(self.box, self.spx, self.spy));
+        bool operator()(const box_t &v) {
+            auto test_box = get_test_box(top);
+            // same as !bp::empty(v & test_box), without building a polygon set
+            if (std::max(xl(v), xl(test_box)) >= std::min(xh(v), xh(test_box)) ||
+                std::max(yl(v), yl(test_box)) >= std::min(yh(v), yh(test_box)))
+                return false;
+            set_value(v);
             return true;
         }
 
         template <typename T> bool operator()(const T &v) {
-            auto test_box = get_expand(self.box, std::max(self.spx, self.cur->spx),
-                                       std::max(self.spy, self.cur->spy));
-            if (bp::empty(v & test_box)) {
-                ++self.cur;
-                return true;
-            }
+            if (bp::empty(v & get_test_box(top)))
+                return false;
+            set_value(v);
+            return true;
+        }
+
+        box_t get_test_box(const geo_traversal::frame &f) const {
+            return get_expand(f.box, std::max(f.spx, f.cur->spx), std::max(f.spy, f.cur->spy));
+        }
+
+        template <typename T> void set_value(const T &v) {
             self.cur_val = geo_union(v);
-            std::visit(xform_visitor(self.xform), self.cur_val.val);
-            return false;
+            std::visit(xform_visitor(top.xform), self.cur_val.val);
         }
     };
 
-    // advance the iterator to the next point that
-    static void get_val_reference(geo_iterator &self) {
-        for (auto repeat = true; repeat;) {
-            if (self.inner == nullptr) {
-                // no inner loop
-                if (self.cur == self.end) {
-                    return;
-                } else {
-                    // still has item, check intersection
-                    repeat = std::visit(geo_visitor(self), self.cur->val);
-                }
-            } else {
-                // has inner loop
-                if (self.inner->has_next()) {
-                    // get inner item
-                    self.cur_val = *(*self.inner);
-                    std::visit(xform_visitor(self.xform), self.cur_val.val);
-                    return;
-                } else {
-                    // no more inner items
-                    self.inner.reset();
-                    ++self.cur;
-                }
-            }
+    // advance the iterator to the next flat geometry that intersects the query box
+    static void find_next(geo_iterator &self) {
+        for (; self.trav.find_leaf(); self.trav.skip()) {
+            auto &top = self.trav.top();
+            if (std::visit(geo_visitor(self, top), top.cur->val))
+                return;
         }
     }
 };
@@ -79,20 +188,18 @@ struct geo_iterator::helper {
 geo_iterator::geo_iterator() = default;
 
 geo_iterator::geo_iterator(const box_t &box, offset_t spx, offset_t spy, geo_query_iter &&cur,
-                           geo_query_iter &&end, const cbag::transformation &xform)
-    : box(box), spx(spx), spy(spy), cur(std::move(cur)), end(std::move(end)), xform(xform) {
-    helper::get_val_reference(*this);
+                           const cbag::transformation &xform)
+    : trav(box, spx, spy, std::move(cur), xform) {
+    helper::find_next(*this);
 }
 
-bool geo_iterator::has_next() const { return cur != end; }
+bool geo_iterator::has_next() const { return trav.has_next(); }
 
 geo_iterator &geo_iterator::operator++() {
-    if (inner == nullptr) {
-        ++cur;
-    } else {
-        ++(*inner);
+    if (trav.has_next()) {
+        trav.skip();
+        helper::find_next(*this);
     }
-    helper::get_val_reference(*this);
     return *this;
 }
 
@@ -104,13 +211,7 @@ geo_iterator geo_iterator::operator++(int) {
 
 geo_iterator::reference geo_iterator::operator*() const { return cur_val; }
 
-bool geo_iterator::operator==(const geo_iterator &rhs) const {
-    auto a = has_next();
-    auto b = rhs.has_next();
-    return (!a && !b) ||
-           (a && b && box == rhs.box && spx == rhs.spx && spy == rhs.spy && cur == rhs.cur &&
-            end == rhs.end && xform == rhs.xform && inner == rhs.inner);
-}
+bool geo_iterator::operator==(const geo_iterator &rhs) const { return trav == rhs.trav; }
 
 bool geo_iterator::operator!=(const geo_iterator &rhs) const { return !(*this == rhs); }
 
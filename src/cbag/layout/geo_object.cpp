@@ -16,6 +16,11 @@ bool geo_object::operator==(const geo_object &v) const {
 
 const geo_instance *geo_object::get_instance() const { return std::get_if<geo_instance>(&val); }
 
+box_t geo_object::get_bbox() const {
+    return {bnd_box.min_corner().get<0>() + spx, bnd_box.min_corner().get<1>() + spy,
+            bnd_box.max_corner().get<0>() - spx, bnd_box.max_corner().get<1>() - spy};
+}
+
 bg_box get_bnd_box(const geo_object::value_type &val, offset_t spx, offset_t spy) {
     box_t box;
     std::visit(overload{[&box](const box_t &v) { box = v; },
@@ -1,47 +1,132 @@
+#include <algorithm>
+#include <iterator>
+
+#include <fmt/core.h>
+
 #include <cbag/common/box_t.h>
 #include <cbag/common/box_t_adapt.h>
+#include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation.h>
 #include <cbag/layout/geo_iterator.h>
 #include <cbag/layout/geometry.h>
+#include <cbag/layout/polygon.h>
 #include <cbag/layout/routing_grid_util.h>
 
 namespace cbag {
 namespace layout {
 
-struct geometry::helper {};
+struct geometry::helper {
+    template <typename S>
+    static S make_set(const box_list &boxes, const std::vector<box_array> &arr_list) {
+        S ans;
+        for (const auto &box : boxes) {
+            ans.insert(box);
+        }
+        for (const auto &arr : arr_list) {
+            arr.for_each([&ans](const box_t &box) { ans.insert(box); });
+        }
+        return ans;
+    }
 
-geometry::geometry(geometry_mode mode) : mode(mode) {
-    if (mode != geometry_mode::POLY90)
-        reset_to_mode(mode);
-}
+    static geometry_data make_polygon_set(const geometry &self, const box_list &boxes) {
+        switch (self.mode) {
+        case geometry_mode::POLY90:
+            return make_set<polygon90_set>(boxes, self.arr_list);
+        case geometry_mode::POLY45:
+            return make_set<polygon45_set>(boxes, self.arr_list);
+        default:
+            return make_set<polygon_set>(boxes, self.arr_list);
+        }
+    }
+
+    // convert rectangle data to polygon set, called before adding non-rectangular shapes.
+    static void to_polygon_set(geometry &self) {
+        auto boxes = std::get_if<box_list>(&self.data);
+        if (boxes != nullptr) {
+            self.data = make_polygon_set(self, *boxes);
+            self.arr_list.clear();
+            self.merged.emplace<box_list>();
+        }
+    }
+
+    static void clean(const geometry_data &data) {
+        std::visit(
+            overload{
+                [](const box_list &d) {},
+                [](const auto &d) { d.clean(); },
+            },
+            data);
+    }
+
+    static void check_mode(const geometry &self, geometry_mode min_mode, const char *name) {
+        if (static_cast<enum_t>(self.mode) < static_cast<enum_t>(min_mode))
+            throw std::invalid_argument(
+                fmt::format("Cannot add {}; incorrect cellview layout mode.", name));
+    }
+};
+
+geometry::geometry(geometry_mode mode) : mode(mode) { reset_to_mode(mode); }
 
 bool geometry::operator==(const geometry &rhs) const noexcept {
-    return mode == rhs.mode && data == rhs.data;
+    // polygon sets compare merged regions, so rectangles are compared after merging.
+    return mode == rhs.mode && get_merged() == rhs.get_merged();
 }
 
+bool geometry::is_rect_only() const noexcept { return std::holds_alternative<box_list>(data); }
+
 box_t geometry::get_bbox() const {
-    box_t ans;
+    box_t ans = box_t::get_invalid_box();
     bool success = std::visit(
         overload{
+            [this, &ans](const box_list &d) {
+                for (const auto &box : d) {
+                    if (is_physical(box))
+                        cbag::merge(ans, box);
+                }
+                for (const auto &arr : arr_list) {
+                    cbag::merge(ans, arr.get_bbox());
+                }
+                return is_valid(ans);
+            },
             [&ans](const auto &d) { return bp::extents(ans, d); },
         },
-        data);
+        std::holds_alternative<box_list>(data) ? data : get_merged());
 
     if (!success)
         return box_t::get_invalid_box();
     return ans;
 }
 
+void geometry::merge() const { get_merged(); }
+
+util::hash128 geometry::get_region_hash() const {
+    auto &merged_data = get_merged();
+    if (!region_hash) {
+        // polygons are extracted from the cleaned set, whose data is in canonical order.
+        std::vector<polygon> poly_list;
+        write_data(merged_data, poly_list);
+        util::hasher128 h;
+        h.add(static_cast<enum_t>(mode)).add(poly_list.size());
+        for (const auto &poly : poly_list) {
+            h.add(poly.size());
+            for (const auto &pt : poly) {
+                h.add(pt.x()).add(pt.y());
+            }
+        }
+        region_hash = h.get();
+    }
+    return *region_hash;
+}
+
 void geometry::reset_to_mode(geometry_mode m) {
     switch (m) {
     case geometry_mode::POLY90:
-        data.emplace<polygon90_set>();
-        break;
     case geometry_mode::POLY45:
-        data.emplace<polygon45_set>();
-        break;
     case geometry_mode::POLY:
-        data.emplace<polygon_set>();
+        data.emplace<box_list>();
+        arr_list.clear();
+        merged.emplace<box_list>();
+        dirty = true;
         break;
     default:
         throw std::invalid_argument("Unknown geometry mode: " +
@@ -50,58 +135,117 @@ void geometry::reset_to_mode(geometry_mode m) {
     mode = m;
 }
 
+const geometry::geometry_data &geometry::get_merged() const {
+    auto boxes = std::get_if<box_list>(&data);
+    if (boxes == nullptr) {
+        if (dirty) {
+            helper::clean(data);
+            region_hash.reset();
+            dirty = false;
+        }
+        return data;
+    }
+    if (dirty) {
+        region_hash.reset();
+        merged = helper::make_polygon_set(*this, *boxes);
+        helper::clean(merged);
+        dirty = false;
+    }
+    return merged;
+}
+
 void geometry::add_shape(const box_t &obj) {
+    dirty = true;
     std::visit(
         overload{
-            [&obj](polygon90_set &d) { d.insert(obj); },
-            [&obj](polygon45_set &d) { d.insert(obj); },
-            [&obj](polygon_set &d) { d.insert(obj); },
+            [&obj](box_list &d) {
+                if (is_physical(obj))
+                    d.push_back(obj);
+            },
+            [&obj](auto &d) { d.insert(obj); },
         },
         data);
 }
 
-void geometry::add_shape(const polygon90 &obj) {
+void geometry::add_shapes(const std::vector<box_t> &obj_list) {
+    if (obj_list.empty())
+        return;
+    dirty = true;
     std::visit(
         overload{
-            [&obj](polygon90_set &d) { d.insert(obj); },
-            [&obj](polygon45_set &d) { d.insert(obj); },
-            [&obj](polygon_set &d) { d.insert(obj); },
+            [&obj_list](box_list &d) {
+                d.reserve(d.size() + obj_list.size());
+                std::copy_if(obj_list.begin(), obj_list.end(), std::back_inserter(d),
+                             [](const box_t &obj) { return is_physical(obj); });
+            },
+            [&obj_list](auto &d) {
+                for (const auto &obj : obj_list) {
+                    d.insert(obj);
+                }
+            },
         },
         data);
 }
 
-void geometry::add_shape(const polygon45 &obj) {
+void geometry::add_shape(const box_array &obj) {
+    if (obj.empty())
+        return;
+    dirty = true;
     std::visit(
         overload{
-            [](polygon90_set &d) {
-                throw std::invalid_argument("Cannot add poly45; incorrect cellview layout mode.");
-            },
-            [&obj](polygon45_set &d) { d.insert(obj); },
-            [&obj](polygon_set &d) { d.insert(obj); },
+            [this, &obj](box_list &d) { arr_list.push_back(obj); },
+            [&obj](auto &d) { obj.for_each([&d](const box_t &box) { d.insert(box); }); },
         },
         data);
 }
 
-void geometry::add_shape(const polygon &obj) {
+void geometry::add_shape(const polygon90 &obj) {
+    // rectangular polygons stay on the rectangle path
+    if (std::holds_alternative<box_list>(data) && obj.size() == 4) {
+        box_t box;
+        bp::extents(box, obj);
+        add_shape(box);
+        return;
+    }
+    dirty = true;
+    helper::to_polygon_set(*this);
     std::visit(
         overload{
-            [](polygon90_set &d) {
-                throw std::invalid_argument("Cannot add poly; incorrect cellview layout mode.");
-            },
-            [](polygon45_set &d) {
-                throw std::invalid_argument("Cannot add poly; incorrect cellview layout mode.");
-            },
+            [](box_list &d) {},
+            [&obj](auto &d) { d.insert(obj); },
+        },
+        data);
+}
+
+void geometry::add_shape(const polygon45 &obj) {
+    dirty = true;
+    helper::check_mode(*this, geometry_mode::POLY45, "poly45");
+    helper::to_polygon_set(*this);
+    std::visit(
+        overload{
+            [](box_list &d) {},
+            [](polygon90_set &d) {},
+            [&obj](polygon45_set &d) { d.insert(obj); },
             [&obj](polygon_set &d) { d.insert(obj); },
         },
         data);
 }
 
+void geometry::add_shape(const polygon &obj) {
+    dirty = true;
+    helper::check_mode(*this, geometry_mode::POLY, "poly");
+    helper::to_polygon_set(*this);
+    std::get<polygon_set>(data).insert(obj);
+}
+
 void geometry::add_shape(const polygon45_set &obj) {
+    dirty = true;
+    helper::check_mode(*this, geometry_mode::POLY45, "poly45");
+    helper::to_polygon_set(*this);
     std::visit(
         overload{
-            [](polygon90_set &d) {
-                throw std::invalid_argument("Cannot add poly45; incorrect cellview layout mode.");
-            },
+            [](box_list &d) {},
+            [](polygon90_set &d) {},
             [&obj](polygon45_set &d) { d.insert(obj); },
             [&obj](polygon_set &d) { d.insert(obj); },
         },
@@ -0,0 +1,522 @@
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+
+#include <fmt/core.h>
+
+#include <cbag/common/box_t_util.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/enum/direction.h>
+#include <cbag/enum/round_mode.h>
+#include <cbag/layout/cellview.h>
+#include <cbag/layout/grid_object.h>
+#include <cbag/layout/grid_router.h>
+#include <cbag/layout/routing_grid.h>
+#include <cbag/layout/routing_grid_util.h>
+#include <cbag/layout/track_info_util.h>
+#include <cbag/layout/via_param_util.h>
+#include <cbag/layout/via_wrapper.h>
+
+namespace cbag {
+namespace layout {
+
+namespace {
+
+/** Returns the via box and via parameters of a via between level and level + 1.
+ *
+ *  The via box is the intersection of the two single-track wires.
+ */
+std::tuple<box_t, via_param> get_route_via(const routing_grid &grid, level_t level, htr_t htr,
+                                           htr_t adj_htr, via_def_t vdef) {
+    auto dir0 = grid.track_info_at(level).get_direction();
+    auto dir1 = grid.track_info_at(level + 1).get_direction();
+    auto bnds0 = get_wire_bounds(grid, level, htr, 1);
+    auto bnds1 = get_wire_bounds(grid, level + 1, adj_htr, 1);
+    auto via_box = box_t(dir0, bnds1[0], bnds1[1], bnds0[0], bnds0[1]);
+    auto params =
+        grid.get_tech()->get_via_param(dim(via_box), vdef, direction::LOWER, dir0, dir1, true);
+    return {via_box, std::move(params)};
+}
+
+} // namespace
+
+struct grid_router::helper {
+    static constexpr uint8_t unknown = 0;
+    static constexpr uint8_t clear = 1;
+    static constexpr uint8_t blocked = 2;
+
+    struct node_t {
+        std::size_t lev_idx;
+        std::size_t tr_idx;
+        std::size_t stop_idx;
+    };
+
+    static std::size_t find_index(const std::vector<offset_t> &vec, offset_t val) {
+        auto iter = std::lower_bound(vec.begin(), vec.end(), val);
+        return (iter == vec.end() || *iter != val) ? npos
+                                                   : static_cast<std::size_t>(iter - vec.begin());
+    }
+
+    static std::vector<std::size_t> find_indices(const std::vector<offset_t> &vec,
+                                                 const std::vector<offset_t> &vals) {
+        std::vector<std::size_t> ans;
+        ans.reserve(vals.size());
+        for (auto val : vals) {
+            ans.push_back(find_index(vec, val));
+        }
+        return ans;
+    }
+
+    /** Returns the first full track index and the coordinates of all full tracks in [lo, hi].
+     */
+    static std::tuple<htr_t, std::vector<offset_t>> get_tracks(const track_info &tinfo,
+                                                               offset_t lo, offset_t hi) {
+        auto htr_lo = coord_to_htr(tinfo, lo, round_mode::GREATER_EQ);
+        auto htr_hi = coord_to_htr(tinfo, hi, round_mode::LESS_EQ);
+        htr_lo += (htr_lo & 1);
+        htr_hi -= (htr_hi & 1);
+        std::vector<offset_t> coords;
+        for (auto htr = htr_lo; htr <= htr_hi; htr += 2) {
+            coords.push_back(htr_to_coord(tinfo, htr));
+        }
+        return {htr_lo, std::move(coords)};
+    }
+
+    static std::size_t get_id(const level_info &info, std::size_t tr_idx, std::size_t stop_idx) {
+        return info.offset + tr_idx * info.stops.size() + stop_idx;
+    }
+
+    static node_t get_node(const grid_router &self, std::size_t id) {
+        auto lev_idx = self.lev_list.size() - 1;
+        for (; self.lev_list[lev_idx].offset > id; --lev_idx)
+            ;
+        auto &info = self.lev_list[lev_idx];
+        auto rel = id - info.offset;
+        auto num_stops = info.stops.size();
+        return {lev_idx, rel / num_stops, rel % num_stops};
+    }
+
+    static std::size_t find_node(const grid_router &self, const route_point &pt) {
+        auto lev_idx = static_cast<std::size_t>(pt.level - self.bot_level);
+        if (pt.level < self.bot_level || lev_idx >= self.lev_list.size() || (pt.htr & 1) != 0)
+            return npos;
+        auto &info = self.lev_list[lev_idx];
+        auto tr_idx = static_cast<std::size_t>((pt.htr - info.htr0) / 2);
+        if (pt.htr < info.htr0 || tr_idx >= info.tr_coords.size())
+            return npos;
+        auto stop_idx = find_index(info.stops, pt.coord);
+        return (stop_idx == npos) ? npos : get_id(info, tr_idx, stop_idx);
+    }
+
+    static std::array<offset_t, 2> get_xy(const grid_router &self, const node_t &node) {
+        auto &info = self.lev_list[node.lev_idx];
+        auto coord = info.stops[node.stop_idx];
+        auto tr_coord = info.tr_coords[node.tr_idx];
+        return (info.dir == orient_2d::HORIZONTAL) ? std::array<offset_t, 2>{coord, tr_coord}
+                                                   : std::array<offset_t, 2>{tr_coord, coord};
+    }
+
+    static bool is_inside(const box_t &outer, const box_t &inner) {
+        return xl(outer) <= xl(inner) && yl(outer) <= yl(inner) && xh(inner) <= xh(outer) &&
+               yh(inner) <= yh(outer);
+    }
+
+    /** Returns true if no shape, other than the shapes of the net being routed, is too close to
+     *  the given box.
+     */
+    static bool is_clear(const grid_router &self, level_t level, layer_t key, const box_t &box) {
+        auto &grid = *self.cv_ptr->get_grid();
+        auto [spx, spy] = get_margins(grid, key, level, box);
+        auto &net_boxes = self.net_list[static_cast<std::size_t>(level - self.bot_level)];
+        return !self.cv_ptr->get_geo_index(level).visit_intersect(
+            box, spx, spy, make_xform(), [&net_boxes](const geo_view &v) {
+                auto obj_box = get_transform(v.bbox, v.xform);
+                return std::none_of(
+                    net_boxes.begin(), net_boxes.end(),
+                    [&obj_box](const box_t &net_box) { return is_inside(net_box, obj_box); });
+            });
+    }
+
+    static std::optional<via_def_t> find_via_def(grid_router &self, layer_t bot_key,
+                                                 layer_t top_key) {
+        auto iter = self.vdef_cache.find({bot_key, top_key});
+        if (iter == self.vdef_cache.end()) {
+            std::optional<via_def_t> vdef;
+            try {
+                vdef = self.cv_ptr->get_tech()->get_via_def(direction::LOWER, bot_key, top_key);
+            } catch (const std::out_of_range &) {
+            }
+            iter = self.vdef_cache.emplace(std::make_pair(bot_key, top_key), vdef).first;
+        }
+        return iter->second;
+    }
+
+    /** Returns true if the wire from the given node to the next stop is clear.
+     */
+    static bool wire_clear(grid_router &self, std::size_t id, const node_t &node) {
+        auto &state = self.wire_state[id];
+        if (state == unknown) {
+            auto &grid = *self.cv_ptr->get_grid();
+            auto &info = self.lev_list[node.lev_idx];
+            auto level = self.bot_level + static_cast<level_t>(node.lev_idx);
+            auto htr = info.htr0 + 2 * static_cast<htr_t>(node.tr_idx);
+            auto bnds = get_wire_bounds(grid, level, htr, 1);
+            auto half_w = (bnds[1] - bnds[0]) / 2;
+            auto box = box_t(info.dir, info.stops[node.stop_idx] - half_w,
+                             info.stops[node.stop_idx + 1] + half_w, bnds[0], bnds[1]);
+            state = is_clear(self, level, get_layer_t(grid, level, htr), box) ? clear : blocked;
+        }
+        return state == clear;
+    }
+
+    /** Returns true if a via from the given node to the level above is legal and clear.
+     */
+    static bool via_clear(grid_router &self, std::size_t id, const node_t &node) {
+        auto &state = self.via_state[id];
+        if (state == unknown) {
+            state = blocked;
+            auto &grid = *self.cv_ptr->get_grid();
+            auto &info = self.lev_list[node.lev_idx];
+            auto &adj_info = self.lev_list[node.lev_idx + 1];
+            auto level = self.bot_level + static_cast<level_t>(node.lev_idx);
+            auto htr = info.htr0 + 2 * static_cast<htr_t>(node.tr_idx);
+            auto adj_htr = adj_info.htr0 + 2 * static_cast<htr_t>(info.up_tr[node.stop_idx]);
+            auto key = get_layer_t(grid, level, htr);
+            auto adj_key = get_layer_t(grid, level + 1, adj_htr);
+            auto vdef = find_via_def(self, key, adj_key);
+            if (vdef) {
+                auto [via_box, params] = get_route_via(grid, level, htr, adj_htr, *vdef);
+                if (!empty(params)) {
+                    auto dir0 = info.dir;
+                    auto dir1 = adj_info.dir;
+                    auto ext =
+                        get_via_extensions(params, dim(via_box), direction::LOWER, dir0, dir1);
+                    auto box0 = box_t(dir0, lower(via_box, dir0) - ext[0],
+                                      upper(via_box, dir0) + ext[0], lower(via_box, dir1),
+                                      upper(via_box, dir1));
+                    auto box1 = box_t(dir1, lower(via_box, dir1) - ext[1],
+                                      upper(via_box, dir1) + ext[1], lower(via_box, dir0),
+                                      upper(via_box, dir0));
+                    if (is_clear(self, level, key, box0) &&
+                        is_clear(self, level + 1, adj_key, box1))
+                        state = clear;
+                }
+            }
+        }
+        return state == clear;
+    }
+
+    /** Calls fn(neighbor_id, cost) on every neighbor of the given node reachable in one step.
+     */
+    template <typename F>
+    static void for_each_neighbor(grid_router &self, std::size_t id, const node_t &node, F fn) {
+        auto &info = self.lev_list[node.lev_idx];
+        if (node.stop_idx > 0 && wire_clear(self, id - 1, {node.lev_idx, node.tr_idx,
+                                                           node.stop_idx - 1})) {
+            fn(id - 1, info.stops[node.stop_idx] - info.stops[node.stop_idx - 1]);
+        }
+        if (node.stop_idx + 1 < info.stops.size() && wire_clear(self, id, node)) {
+            fn(id + 1, info.stops[node.stop_idx + 1] - info.stops[node.stop_idx]);
+        }
+        if (node.lev_idx > 0) {
+            auto adj_tr = info.dn_tr[node.stop_idx];
+            auto adj_stop = info.dn_stop[node.tr_idx];
+            if (adj_tr != npos && adj_stop != npos) {
+                auto &adj_info = self.lev_list[node.lev_idx - 1];
+                auto adj_id = get_id(adj_info, adj_tr, adj_stop);
+                if (via_clear(self, adj_id, {node.lev_idx - 1, adj_tr, adj_stop}))
+                    fn(adj_id, self.via_cost);
+            }
+        }
+        if (node.lev_idx + 1 < self.lev_list.size()) {
+            auto adj_tr = info.up_tr[node.stop_idx];
+            auto adj_stop = info.up_stop[node.tr_idx];
+            if (adj_tr != npos && adj_stop != npos && via_clear(self, id, node)) {
+                fn(get_id(self.lev_list[node.lev_idx + 1], adj_tr, adj_stop), self.via_cost);
+            }
+        }
+    }
+
+    /** Returns a lower bound of the cost from the given node to the nearest target.
+     */
+    static cost_t get_heuristic(const grid_router &self, const node_t &node,
+                                const std::vector<node_t> &tgt_list) {
+        auto xy = get_xy(self, node);
+        auto ans = std::numeric_limits<cost_t>::max();
+        for (const auto &tgt : tgt_list) {
+            auto txy = get_xy(self, tgt);
+            auto num_vias = static_cast<cost_t>(
+                std::abs(static_cast<long>(node.lev_idx) - static_cast<long>(tgt.lev_idx)));
+            ans = std::min(ans, static_cast<cost_t>(std::abs(xy[0] - txy[0])) +
+                                    static_cast<cost_t>(std::abs(xy[1] - txy[1])) +
+                                    num_vias * self.via_cost);
+        }
+        return ans;
+    }
+
+    static void next_stamp(grid_router &self) {
+        if (++self.cur_stamp == 0) {
+            std::fill(self.open_stamp.begin(), self.open_stamp.end(), 0);
+            std::fill(self.closed_stamp.begin(), self.closed_stamp.end(), 0);
+            self.cur_stamp = 1;
+        }
+    }
+
+    /** Runs A* from all source nodes to the nearest target node.
+     *
+     *  @return the target node that was reached, or npos.
+     */
+    static std::size_t search(grid_router &self, const std::vector<std::size_t> &src_list,
+                              const std::vector<std::size_t> &tgt_ids) {
+        std::vector<node_t> tgt_list;
+        tgt_list.reserve(tgt_ids.size());
+        for (auto id : tgt_ids) {
+            self.target_mark[id] = 1;
+            tgt_list.push_back(get_node(self, id));
+        }
+
+        next_stamp(self);
+        auto stamp = self.cur_stamp;
+        self.heap.reset(self.num_nodes);
+        for (auto id : src_list) {
+            if (self.open_stamp[id] != stamp) {
+                self.open_stamp[id] = stamp;
+                self.g_list[id] = 0;
+                self.parent_list[id] = npos;
+                auto h = get_heuristic(self, get_node(self, id), tgt_list);
+                self.heap.push(id, {h, h});
+            }
+        }
+
+        auto ans = npos;
+        while (!self.heap.empty()) {
+            auto id = self.heap.top();
+            self.heap.pop();
+            self.closed_stamp[id] = stamp;
+            if (self.target_mark[id]) {
+                ans = id;
+                break;
+            }
+            auto g = self.g_list[id];
+            for_each_neighbor(self, id, get_node(self, id), [&](std::size_t nid, cost_t cost) {
+                if (self.closed_stamp[nid] == stamp)
+                    return;
+                auto ng = g + cost;
+                if (self.open_stamp[nid] != stamp || ng < self.g_list[nid]) {
+                    self.open_stamp[nid] = stamp;
+                    self.g_list[nid] = ng;
+                    self.parent_list[nid] = id;
+                    auto h = get_heuristic(self, get_node(self, nid), tgt_list);
+                    self.heap.push(nid, {ng + h, h});
+                }
+            });
+        }
+
+        for (auto id : tgt_ids) {
+            self.target_mark[id] = 0;
+        }
+        return ans;
+    }
+
+    /** Appends the path ending at the given node to the route and the source list.
+     */
+    static void add_path(grid_router &self, std::size_t id, route_result &ans,
+                         std::vector<std::size_t> &src_list) {
+        std::vector<std::size_t> path;
+        for (auto cur = id; cur != npos; cur = self.parent_list[cur]) {
+            path.push_back(cur);
+        }
+        std::reverse(path.begin(), path.end());
+        ans.cost += self.g_list[id];
+        src_list.insert(src_list.end(), path.begin() + 1, path.end());
+
+        auto get_level = [&self](const node_t &node) {
+            return self.bot_level + static_cast<level_t>(node.lev_idx);
+        };
+        auto get_htr = [&self](const node_t &node) {
+            return self.lev_list[node.lev_idx].htr0 + 2 * static_cast<htr_t>(node.tr_idx);
+        };
+        auto start = get_node(self, path[0]);
+        auto prev = start;
+        auto add_wire = [&](const node_t &last) {
+            if (start.stop_idx != last.stop_idx) {
+                auto &stops = self.lev_list[start.lev_idx].stops;
+                auto lo = std::min(start.stop_idx, last.stop_idx);
+                auto hi = std::max(start.stop_idx, last.stop_idx);
+                ans.wires.push_back(
+                    route_wire{get_level(start), get_htr(start), {stops[lo], stops[hi]}});
+            }
+        };
+        for (std::size_t idx = 1; idx < path.size(); ++idx) {
+            auto cur = get_node(self, path[idx]);
+            if (cur.lev_idx != prev.lev_idx) {
+                add_wire(prev);
+                auto &bot = (cur.lev_idx < prev.lev_idx) ? cur : prev;
+                auto &top = (cur.lev_idx < prev.lev_idx) ? prev : cur;
+                ans.vias.push_back(route_via{get_level(bot), get_htr(bot), get_htr(top)});
+                start = cur;
+            }
+            prev = cur;
+        }
+        add_wire(prev);
+    }
+};
+
+grid_router::grid_router(const cellview &cv, level_t bot_level, level_t top_level,
+                         const box_t &bnds, cost_t via_cost)
+    : cv_ptr(&cv), bot_level(bot_level), via_cost(via_cost) {
+    auto &grid = *cv.get_grid();
+    auto grid_bot = grid.get_bot_level();
+    auto grid_top = grid.get_top_level();
+    if (bot_level > top_level || bot_level < grid_bot || top_level > grid_top)
+        throw std::out_of_range(fmt::format("Invalid routing levels [{}, {}] for grid levels "
+                                            "[{}, {}]",
+                                            bot_level, top_level, grid_bot, grid_top));
+    if (via_cost < 0)
+        throw std::invalid_argument(fmt::format("Negative via cost: {}", via_cost));
+
+    auto num_lev = static_cast<std::size_t>(top_level - bot_level + 1);
+    lev_list.resize(num_lev);
+    net_list.resize(num_lev);
+    for (std::size_t idx = 0; idx < num_lev; ++idx) {
+        auto level = bot_level + static_cast<level_t>(idx);
+        auto &tinfo = grid.track_info_at(level);
+        auto &info = lev_list[idx];
+        info.dir = tinfo.get_direction();
+        auto pdir = perpendicular(info.dir);
+        std::tie(info.htr0, info.tr_coords) =
+            helper::get_tracks(tinfo, lower(bnds, pdir), upper(bnds, pdir));
+
+        // wires stop where they cross tracks of the orthogonal levels above and below
+        for (auto adj_level : {level - 1, level + 1}) {
+            if (adj_level < bot_level || adj_level > top_level)
+                continue;
+            auto &adj_tinfo = grid.track_info_at(adj_level);
+            if (adj_tinfo.get_direction() == info.dir)
+                continue;
+            auto [adj_htr0, adj_coords] =
+                helper::get_tracks(adj_tinfo, lower(bnds, info.dir), upper(bnds, info.dir));
+            info.stops.insert(info.stops.end(), adj_coords.begin(), adj_coords.end());
+        }
+        std::sort(info.stops.begin(), info.stops.end());
+        info.stops.erase(std::unique(info.stops.begin(), info.stops.end()), info.stops.end());
+
+        info.offset = num_nodes;
+        num_nodes += info.tr_coords.size() * info.stops.size();
+        info.dn_tr.resize(info.stops.size(), npos);
+        info.up_tr.resize(info.stops.size(), npos);
+        info.dn_stop.resize(info.tr_coords.size(), npos);
+        info.up_stop.resize(info.tr_coords.size(), npos);
+    }
+
+    // link crossing tracks of adjacent orthogonal levels
+    for (std::size_t idx = 0; idx + 1 < num_lev; ++idx) {
+        auto &info = lev_list[idx];
+        auto &adj_info = lev_list[idx + 1];
+        if (info.dir != adj_info.dir) {
+            info.up_tr = helper::find_indices(adj_info.tr_coords, info.stops);
+            info.up_stop = helper::find_indices(adj_info.stops, info.tr_coords);
+            adj_info.dn_tr = helper::find_indices(info.tr_coords, adj_info.stops);
+            adj_info.dn_stop = helper::find_indices(info.stops, adj_info.tr_coords);
+        }
+    }
+
+    wire_state.resize(num_nodes, helper::unknown);
+    via_state.resize(num_nodes, helper::unknown);
+    open_stamp.resize(num_nodes, 0);
+    closed_stamp.resize(num_nodes, 0);
+    target_mark.resize(num_nodes, 0);
+    g_list.resize(num_nodes, 0);
+    parent_list.resize(num_nodes, npos);
+    heap.reset(num_nodes);
+}
+
+std::size_t grid_router::get_num_nodes() const noexcept { return num_nodes; }
+
+bool grid_router::is_node(const route_point &pt) const {
+    return helper::find_node(*this, pt) != npos;
+}
+
+route_result grid_router::route(const route_point &src, const route_point &dst,
+                                const std::vector<std::pair<level_t, box_t>> &net_boxes) {
+    return route(std::vector<route_point>{src, dst}, net_boxes);
+}
+
+route_result grid_router::route(const std::vector<route_point> &terms,
+                                const std::vector<std::pair<level_t, box_t>> &net_boxes) {
+    std::vector<std::size_t> id_list;
+    id_list.reserve(terms.size());
+    for (const auto &pt : terms) {
+        auto id = helper::find_node(*this, pt);
+        if (id == npos)
+            throw std::invalid_argument(fmt::format(
+                "Route terminal (level={}, htr={}, coord={}) is not on the routing lattice.",
+                pt.level, pt.htr, pt.coord));
+        id_list.push_back(id);
+    }
+
+    // the cellview may have changed since the last call
+    std::fill(wire_state.begin(), wire_state.end(), helper::unknown);
+    std::fill(via_state.begin(), via_state.end(), helper::unknown);
+    for (auto &box_list : net_list) {
+        box_list.clear();
+    }
+    for (const auto &[level, box] : net_boxes) {
+        auto lev_idx = static_cast<std::size_t>(level - bot_level);
+        if (level >= bot_level && lev_idx < net_list.size())
+            net_list[lev_idx].push_back(box);
+    }
+
+    route_result ans;
+    if (id_list.empty()) {
+        ans.success = true;
+        return ans;
+    }
+
+    std::vector<std::size_t> src_list{id_list[0]};
+    std::vector<std::size_t> tgt_list(id_list.begin() + 1, id_list.end());
+    std::sort(tgt_list.begin(), tgt_list.end());
+    tgt_list.erase(std::unique(tgt_list.begin(), tgt_list.end()), tgt_list.end());
+    tgt_list.erase(std::remove(tgt_list.begin(), tgt_list.end(), id_list[0]), tgt_list.end());
+    while (!tgt_list.empty()) {
+        auto id = helper::search(*this, src_list, tgt_list);
+        if (id == npos)
+            return route_result{};
+        helper::add_path(*this, id, ans, src_list);
+        // remove all targets the new path passes through
+        std::sort(src_list.begin(), src_list.end());
+        tgt_list.erase(std::remove_if(tgt_list.begin(), tgt_list.end(),
+                                      [&src_list](std::size_t tgt) {
+                                          return std::binary_search(src_list.begin(),
+                                                                    src_list.end(), tgt);
+                                      }),
+                       tgt_list.end());
+    }
+    ans.success = true;
+    return ans;
+}
+
+void add_route(cellview &cv, const route_result &ans) {
+    auto &grid = *cv.get_grid();
+    auto &tech = *grid.get_tech();
+    std::vector<wire_array> warr_list;
+    warr_list.reserve(ans.wires.size());
+    for (const auto &wire : ans.wires) {
+        auto bnds = get_wire_bounds(grid, wire.level, wire.htr, 1);
+        auto half_w = (bnds[1] - bnds[0]) / 2;
+        warr_list.emplace_back(std::make_shared<track_id>(wire.level, wire.htr, 1, 1, 0),
+                               wire.coord[0] - half_w, wire.coord[1] + half_w);
+    }
+    cv.add_warrs(warr_list, warr_list.size());
+    for (const auto &v : ans.vias) {
+        auto key = get_layer_t(grid, v.level, v.htr);
+        auto adj_key = get_layer_t(grid, v.level + 1, v.adj_htr);
+        auto vdef = tech.get_via_def(direction::LOWER, key, adj_key);
+        auto [via_box, params] = get_route_via(grid, v.level, v.htr, v.adj_htr, vdef);
+        cv.add_object(
+            via_wrapper(via(make_xform(xm(via_box), ym(via_box)), vdef, std::move(params)), true));
+    }
+}
+
+} // namespace layout
+} // namespace cbag
@@ -4,6 +4,7 @@
 #include <cbag/common/param_map_util.h>
 #include <cbag/layout/cellview_util.h>
 #include <cbag/layout/instance.h>
+#include <cbag/layout/tech_util.h>
 #include <cbag/util/overload.h>
 
 namespace cbag {
@@ -33,7 +34,10 @@ bool master_equal(const std::variant<const cellview *, cellview_ref> &lhs,
                   const std::variant<const cellview *, cellview_ref> &rhs) {
     return std::visit(
         overload{
-            [](const cellview *a, const cellview *b) { return *a == *b; },
+            // masters are compared by name and content hash, without recursing into them
+            [](const cellview *a, const cellview *b) {
+                return a == b || (a->get_name() == b->get_name() && a->content_equal(*b));
+            },
             [](const cellview_ref &a, const cellview_ref &b) { return a == b; },
             [](auto, auto) { return false; },
         },
@@ -98,11 +102,24 @@ const param_map *instance::get_params() const {
         master);
 }
 
+box_t instance::get_bbox(layer_t key) const {
+    auto r = std::visit(
+        overload{
+            [&key](const cellview *v) { return v->get_bbox(key); },
+            [](const cellview_ref &v) {
+                return box_t{0, 0, 0, 0};
+            },
+        },
+        master);
+
+    return transform(r, xform);
+}
+
 box_t instance::get_bbox(const std::string &layer, const std::string &purpose) const {
     auto r = std::visit(
         overload{
             [&layer, &purpose](const cellview *v) {
-                return cbag::layout::get_bbox(*v, layer, purpose);
+                return v->get_bbox(layer_t_at(*v->get_tech(), layer, purpose));
             },
             [](const cellview_ref &v) {
                 return box_t{0, 0, 0, 0};
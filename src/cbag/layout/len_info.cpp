@@ -11,6 +11,10 @@ len_info::len_info() = default;
 len_info::len_info(std::vector<max_len_data> &&w_al, std::vector<max_len_data> &&md_al)
     : w_al_list(std::move(w_al)), md_al_list(std::move(md_al)) {}
 
+const std::vector<max_len_data> &len_info::get_width_list() const noexcept { return w_al_list; }
+
+const std::vector<max_len_data> &len_info::get_max_dim_list() const noexcept { return md_al_list; }
+
 offset_t get_min_len_width(offset_t w, const std::vector<max_len_data> &vec) {
     for (const auto &[width, area, min_len] : vec) {
         if (w <= width) {
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <tuple>
 
 #include <fmt/core.h>
 
@@ -11,10 +12,54 @@
 namespace cbag {
 namespace layout {
 
+id_name_index::id_name_index() = default;
+
+id_name_index::id_name_index(const std::unordered_map<std::string, uint32_t> &name_map) {
+    // sort by ID, then by name, so duplicate IDs resolve deterministically
+    std::vector<std::pair<uint32_t, const std::string *>> id_list;
+    id_list.reserve(name_map.size());
+    for (const auto &[name, id] : name_map) {
+        id_list.emplace_back(id, &name);
+    }
+    std::sort(id_list.begin(), id_list.end(), [](const auto &a, const auto &b) {
+        return std::tie(a.first, *a.second) < std::tie(b.first, *b.second);
+    });
+
+    // IDs below this limit are stored densely; the limit bounds the memory of the dense vector
+    auto dense_limit = std::max(static_cast<std::size_t>(1024), 4 * id_list.size());
+    name_list.reserve(id_list.size());
+    for (std::size_t list_idx = 0; list_idx < id_list.size(); ++list_idx) {
+        auto [id, name_ptr] = id_list[list_idx];
+        if (list_idx > 0 && id_list[list_idx - 1].first == id)
+            continue;
+        auto idx = static_cast<uint32_t>(name_list.size());
+        name_list.push_back(*name_ptr);
+        if (id < dense_limit) {
+            dense_list.resize(std::max(dense_list.size(), static_cast<std::size_t>(id) + 1), npos);
+            dense_list[id] = idx;
+        } else {
+            sparse_list.emplace_back(id, idx);
+        }
+    }
+}
+
+const std::string *id_name_index::find(uint32_t id) const noexcept {
+    if (id < dense_list.size()) {
+        auto idx = dense_list[id];
+        return (idx == npos) ? nullptr : &name_list[idx];
+    }
+    auto iter = std::lower_bound(sparse_list.begin(), sparse_list.end(), id,
+                                 [](const auto &p, uint32_t val) { return p.first < val; });
+    if (iter == sparse_list.end() || iter->first != id)
+        return nullptr;
+    return &name_list[iter->second];
+}
+
 lp_lookup::lp_lookup() = default;
 
 lp_lookup::lp_lookup(const YAML::Node &parent)
-    : lay_map(parent["layer"].as<lay_map_t>()), purp_map(parent["purpose"].as<purp_map_t>()) {
+    : lay_map(parent["layer"].as<lay_map_t>()), purp_map(parent["purpose"].as<purp_map_t>()),
+      lay_names(lay_map), purp_names(purp_map) {
 
     auto def_purp = parent["default_purpose"].as<std::string>();
     auto pin_purp = parent["pin_purpose"].as<std::string>();
@@ -38,17 +83,18 @@ purp_t lp_lookup::get_default_purpose() const { return default_purpose; }
 purp_t lp_lookup::get_pin_purpose() const { return pin_purpose; }
 
 const std::string &lp_lookup::get_layer_name(lay_t lay_id) const {
-    auto iter = std::find_if(
-        lay_map.begin(), lay_map.end(),
-        [&lay_id](const std::pair<std::string, purp_t> &v) { return lay_id == v.second; });
-    return iter->first;
+    auto ptr = lay_names.find(lay_id);
+    if (ptr == nullptr)
+        throw std::out_of_range(fmt::format("Cannot find layer name for layer ID: {}", lay_id));
+    return *ptr;
 }
 
 const std::string &lp_lookup::get_purpose_name(purp_t purp_id) const {
-    auto iter = std::find_if(
-        purp_map.begin(), purp_map.end(),
-        [&purp_id](const std::pair<std::string, purp_t> &v) { return purp_id == v.second; });
-    return iter->first;
+    auto ptr = purp_names.find(purp_id);
+    if (ptr == nullptr)
+        throw std::out_of_range(
+            fmt::format("Cannot find purpose name for purpose ID: {}", purp_id));
+    return *ptr;
 }
 
 std::optional<lay_t> lp_lookup::get_layer_id(const std::string &layer) const {
@@ -68,5 +114,15 @@ std::optional<purp_t> lp_lookup::get_purpose_id(const std::string &purpose) cons
     return iter->second;
 }
 
+std::vector<std::pair<const std::string *, const std::string *>>
+lp_lookup::get_names(const std::vector<layer_t> &key_list) const {
+    std::vector<std::pair<const std::string *, const std::string *>> ans;
+    ans.reserve(key_list.size());
+    for (const auto &[lay, purp] : key_list) {
+        ans.emplace_back(lay_names.find(lay), purp_names.find(purp));
+    }
+    return ans;
+}
+
 } // namespace layout
 } // namespace cbag
@@ -17,6 +17,13 @@ namespace cbag {
 namespace layout {
 
 struct routing_grid::helper {
+    // the cache is cleared when it reaches this size, which bounds its memory use.
+    static constexpr std::size_t fp_cache_max_size = 4096;
+
+    static std::shared_ptr<flip_parity_cache> make_flip_parity_cache() {
+        return std::make_shared<flip_parity_cache>(fp_cache_max_size);
+    }
+
     static std::size_t get_index(const routing_grid &grid, level_t level) {
         auto idx = static_cast<std::size_t>(level - grid.bot_level);
         if (idx >= grid.info_list.size())
@@ -46,6 +53,49 @@ struct routing_grid::helper {
         }
     }
 
+    /** Returns the coloring period of the given levels along each axis.
+     *
+     *  The parity of a level repeats every 2 * num_colors half-tracks, so shifting a
+     *  transformation by a multiple of this period does not change its flip parity.
+     */
+    static std::array<int64_t, 2> get_parity_period(const routing_grid &grid, level_t bot_level,
+                                                    level_t top_level) {
+        std::array<int64_t, 2> ans = {1, 1};
+        for (auto lev = bot_level; lev <= top_level; ++lev) {
+            auto &tr_info = grid.track_info_at(lev);
+            auto didx = static_cast<orient_2d_t>(tr_info.get_direction());
+            auto num_colors =
+                std::max(grid.tech_ptr->get_num_colors(lev), static_cast<std::size_t>(1));
+            ans[didx] = std::lcm(ans[didx], static_cast<int64_t>(num_colors) * tr_info.get_pitch());
+        }
+        return ans;
+    }
+
+    static flip_parity compute_flip_parity(const routing_grid &grid, level_t bot_level,
+                                           level_t top_level, std::array<offset_t, 2> ascale,
+                                           std::array<coord_t, 2> loc) {
+        std::vector<std::tuple<int, offset_t, offset_t>> data;
+        data.reserve(top_level - bot_level + 1);
+        for (auto lev = bot_level; lev <= top_level; ++lev) {
+            auto &tr_info = grid[lev];
+            auto dir = tr_info.get_direction();
+            auto didx = static_cast<orient_2d_t>(dir);
+            auto coord = loc[didx];
+            auto scale = ascale[didx];
+            auto htr = coord_to_htr(tr_info, coord);
+
+            auto cur_scale = tr_info.par_scale;
+            auto cur_offset = tr_info.par_offset;
+            auto num_colors =
+                std::max(grid.tech_ptr->get_num_colors(lev), static_cast<std::size_t>(1));
+            auto new_scale = cur_scale * scale;
+            auto new_offset = util::pos_mod(static_cast<int>(cur_scale * htr + cur_offset),
+                                            2 * static_cast<int>(num_colors));
+            data.emplace_back(lev, new_scale, new_offset);
+        }
+        return flip_parity(std::move(data));
+    }
+
     static void update_block_pitch(std::vector<track_info> &info_list, level_t bot_level,
                                    level_t top_private, level_t top_ignore) {
         // set ignore layers block pitch
@@ -67,9 +117,10 @@ struct routing_grid::helper {
     }
 };
 
-routing_grid::routing_grid() = default;
+routing_grid::routing_grid() : fp_cache(helper::make_flip_parity_cache()) {}
 
-routing_grid::routing_grid(const tech *t, const std::string &fname) : tech_ptr(t) {
+routing_grid::routing_grid(const tech *t, const std::string &fname)
+    : tech_ptr(t), fp_cache(helper::make_flip_parity_cache()) {
     auto node = YAML::LoadFile(fname);
 
     auto tmp = cbagyaml::int_map_to_vec<track_info>(node["routing_grid"]);
@@ -101,37 +152,36 @@ level_t routing_grid::get_top_ignore_level() const noexcept { return top_ignore_
 
 level_t routing_grid::get_top_private_level() const noexcept { return top_private_level; }
 
+flip_parity_cache &routing_grid::get_flip_parity_cache() const noexcept { return *fp_cache; }
+
 const track_info &routing_grid::track_info_at(level_t level) const {
     auto idx = helper::get_index(*this, level);
     return info_list[idx];
 }
 
-flip_parity routing_grid::get_flip_parity_at(level_t bot_level, level_t top_level,
-                                             const transformation &xform) const {
+std::shared_ptr<const flip_parity>
+routing_grid::get_flip_parity_at(level_t bot_level, level_t top_level,
+                                 const transformation &xform) const {
     if (flips_xy(xform))
         throw std::invalid_argument("Unsupported orientation: " +
                                     std::to_string(orient_code(xform)));
 
-    auto ascale = axis_scale(xform);
+    // reduce the location by the coloring period, so equivalent placements share an entry
+    auto period = helper::get_parity_period(*this, bot_level, top_level);
     auto loc = location(xform);
-    std::vector<std::tuple<int, offset_t, offset_t>> data;
-    data.reserve(top_level - bot_level + 1);
-    for (auto lev = bot_level; lev <= top_level; ++lev) {
-        auto tr_info = operator[](lev);
-        auto dir = tr_info.get_direction();
-        auto didx = static_cast<orient_2d_t>(dir);
-        auto coord = loc[didx];
-        auto scale = ascale[didx];
-        auto htr = coord_to_htr(tr_info, coord);
-
-        auto cur_scale = tr_info.par_scale;
-        auto cur_offset = tr_info.par_offset;
-        auto new_scale = cur_scale * scale;
-        auto new_offset = (cur_scale * htr + cur_offset);
-        data.emplace_back(lev, new_scale, new_offset);
+    flip_parity_query key;
+    key.bot_level = bot_level;
+    key.top_level = top_level;
+    key.orient = orient_code(xform);
+    for (std::size_t idx = 0; idx < 2; ++idx) {
+        auto rem = static_cast<int64_t>(loc[idx]) % period[idx];
+        key.loc[idx] = static_cast<coord_t>((rem < 0) ? rem + period[idx] : rem);
     }
 
-    return flip_parity(std::move(data));
+    if (auto ans = fp_cache->find(key))
+        return *ans;
+    auto fp = helper::compute_flip_parity(*this, bot_level, top_level, axis_scale(xform), loc);
+    return fp_cache->insert(key, std::make_shared<const flip_parity>(std::move(fp)));
 }
 
 cnt_t routing_grid::get_htr_parity(level_t level, htr_t htr) const {
@@ -147,6 +197,7 @@ void routing_grid::set_flip_parity(const flip_parity &fp) {
         info_list[idx].par_scale = scale;
         info_list[idx].par_offset = offset;
     }
+    fp_cache = helper::make_flip_parity_cache();
 }
 
 void routing_grid::set_top_ignore_level(level_t new_level) {
@@ -174,11 +225,13 @@ void routing_grid::set_level(level_t level, bool is_private, orient_2d dir, offs
     if (is_private)
         top_private_level = std::max(top_private_level, level);
     helper::update_block_pitch(info_list, bot_level, top_private_level, top_ignore_level);
+    fp_cache = helper::make_flip_parity_cache();
 }
 
 void routing_grid::set_track_offset(level_t level, offset_t offset) {
     auto idx = helper::get_index(*this, level);
     info_list[idx].offset = offset;
+    fp_cache = helper::make_flip_parity_cache();
 }
 
 } // namespace layout
@@ -15,13 +15,16 @@ namespace layout {
 
 std::array<offset_t, 2> get_margins(const routing_grid &grid, layer_t key, level_t lev,
                                     const box_t &obj) {
-    auto tech_ptr = grid.get_tech();
+    const auto &rules = grid.get_tech()->get_rule_table();
     std::array<offset_t, 2> ans{0, 0};
+    auto idx = rules.get_index(key);
+    if (idx == rule_table::npos)
+        return ans;
     auto dir = grid[lev].get_direction();
     auto pdir = perpendicular(dir);
     auto width = get_dim(obj, pdir);
-    ans[to_int(dir)] = tech_ptr->get_min_space(key, width, space_type::LINE_END, false);
-    ans[to_int(pdir)] = tech_ptr->get_min_space(key, width, space_type::DIFF_COLOR, false);
+    ans[to_int(dir)] = rules.get_min_space(idx, width, space_type::LINE_END, false);
+    ans[to_int(pdir)] = rules.get_min_space(idx, width, space_type::DIFF_COLOR, false);
     return ans;
 }
 
@@ -90,11 +93,11 @@ std::array<offset_t, 2> get_via_extensions(const routing_grid &grid, direction v
     auto adj_wire_width = adj_tr_info.get_wire_width(adj_ntr);
     auto key = get_test_lay_purp(tech, level);
     auto adj_key = get_test_lay_purp(tech, adj_level);
-    auto &via_id = tech.get_via_id(vdir, key, adj_key);
+    auto vdef = tech.get_via_def(vdir, key, adj_key);
     vector vbox_dim;
     vbox_dim[to_int(dir)] = wire_width.get_edge_wire_width();
     vbox_dim[to_int(adj_dir)] = adj_wire_width.get_edge_wire_width();
-    auto via_param = tech.get_via_param(vbox_dim, via_id, vdir, dir, adj_dir, true);
+    auto via_param = tech.get_via_param(vbox_dim, vdef, vdir, dir, adj_dir, true);
 
     if (empty(via_param)) {
         auto vidx = to_int(vdir);
@@ -197,7 +200,7 @@ em_specs_t get_via_em_specs(const routing_grid &grid, direction vdir, level_t le
     auto tdir_idx = to_int(tr_dir);
     auto key = get_test_lay_purp(tech, level);
     auto adj_key = get_test_lay_purp(tech, adj_level);
-    auto &via_id = tech.get_via_id(vdir, key, adj_key);
+    auto vdef = tech.get_via_def(vdir, key, adj_key);
     double idc = 0, iac_rms = 0, iac_peak = 0;
     vector vbox_dim;
     std::array<offset_t, 2> m_dim, adj_m_dim;
@@ -212,7 +215,7 @@ em_specs_t get_via_em_specs(const routing_grid &grid, direction vdir, level_t le
             adj_m_dim[0] = aw;
             adj_m_dim[1] = adj_length;
 
-            auto param = tech.get_via_param(vbox_dim, via_id, vdir, tr_dir, adj_tr_dir, true);
+            auto param = tech.get_via_param(vbox_dim, vdef, vdir, tr_dir, adj_tr_dir, true);
             if (empty(param)) {
                 // no solution: return all zeros
                 return {0, 0, 0};
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <cbag/layout/rule_table.h>
+#include <cbag/util/math.h>
+
+namespace cbag {
+namespace layout {
+
+struct rule_table::helper {
+    /** Returns the index of the first element of [data, data + n) that is not less than val, or n.
+     *
+     *  This is a branchless lower bound search; the loop body compiles to a conditional move.
+     */
+    static std::size_t lower_bound_index(const offset_t *data, std::size_t n,
+                                         offset_t val) noexcept {
+        if (n == 0)
+            return 0;
+        auto base = data;
+        while (n > 1) {
+            auto half = n / 2;
+            base = (base[half] < val) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - data) + static_cast<std::size_t>(*base < val);
+    }
+
+    /** Appends the rules of one layer to the given table.
+     *
+     *  The rules use first-match semantics: the first entry whose width is no less than the
+     *  query width is used.  Only entries whose width exceeds all previous widths can ever
+     *  match, so the rest are dropped.  This leaves a strictly increasing breakpoint list
+     *  suitable for binary search without changing any lookup result.
+     */
+    template <typename T, typename Vec, typename FW, typename FV>
+    static void add_rules(width_table<T> &table, const Vec &vec, FW get_width, FV get_val) {
+        auto start = table.w_list.size();
+        for (const auto &item : vec) {
+            auto w = get_width(item);
+            if (table.w_list.size() == start || table.w_list.back() < w) {
+                table.w_list.push_back(w);
+                table.val_list.push_back(get_val(item));
+            }
+        }
+    }
+
+    template <typename T> static void end_rules(width_table<T> &table) {
+        table.offsets.push_back(static_cast<uint32_t>(table.w_list.size()));
+    }
+
+    static void init_sp_table(width_table<offset_t> &table, const sp_map_t &sp_map,
+                              const std::vector<layer_t> &key_list) {
+        table.offsets.reserve(key_list.size() + 1);
+        table.offsets.push_back(0);
+        for (const auto &key : key_list) {
+            auto iter = sp_map.find(key);
+            if (iter != sp_map.end() && !iter->second.empty()) {
+                const auto &w_sp_list = iter->second;
+                add_rules(
+                    table, w_sp_list, [](const auto &p) { return p.first; },
+                    [](const auto &p) { return p.second; });
+                // widths larger than every breakpoint use the space of the last entry
+                table.w_list.push_back(std::numeric_limits<offset_t>::max());
+                table.val_list.push_back(w_sp_list.back().second);
+            }
+            end_rules(table);
+        }
+    }
+
+    static std::vector<layer_t> get_key_list(const sp_map_grp_t &sp_map_grp,
+                                             const len_map_t &len_map) {
+        std::vector<layer_t> ans;
+        for (const auto &[sp_type, sp_map] : sp_map_grp) {
+            for (const auto &[key, w_sp_list] : sp_map) {
+                ans.push_back(key);
+            }
+        }
+        for (const auto &[key, linfo] : len_map) {
+            ans.push_back(key);
+        }
+        std::sort(ans.begin(), ans.end());
+        ans.erase(std::unique(ans.begin(), ans.end()), ans.end());
+        return ans;
+    }
+};
+
+rule_table::rule_table() = default;
+
+rule_table::rule_table(const sp_map_grp_t &sp_map_grp, const len_map_t &len_map,
+                       const lp_list_t &lp_list) {
+    key_list = helper::get_key_list(sp_map_grp, len_map);
+
+    // build space tables
+    sp_map_t empty_map;
+    for (std::size_t sp_idx = 0; sp_idx < num_sp_types; ++sp_idx) {
+        auto iter = sp_map_grp.find(static_cast<space_type>(sp_idx));
+        if (iter == sp_map_grp.end() && sp_idx == static_cast<std::size_t>(space_type::SAME_COLOR))
+            iter = sp_map_grp.find(space_type::DIFF_COLOR);
+        sp_defined[sp_idx] = (iter != sp_map_grp.end());
+        helper::init_sp_table(sp_tables[sp_idx],
+                              (iter == sp_map_grp.end()) ? empty_map : iter->second, key_list);
+    }
+
+    // build min length tables
+    len_w_table.offsets.reserve(key_list.size() + 1);
+    len_w_table.offsets.push_back(0);
+    len_md_offsets.reserve(key_list.size() + 1);
+    len_md_offsets.push_back(0);
+    for (const auto &key : key_list) {
+        auto iter = len_map.find(key);
+        if (iter != len_map.end()) {
+            helper::add_rules(
+                len_w_table, iter->second.get_width_list(), [](const auto &v) { return v[0]; },
+                [](const auto &v) { return v; });
+            const auto &md_list = iter->second.get_max_dim_list();
+            len_md_list.insert(len_md_list.end(), md_list.begin(), md_list.end());
+        }
+        helper::end_rules(len_w_table);
+        len_md_offsets.push_back(static_cast<uint32_t>(len_md_list.size()));
+    }
+
+    // precompute level indices
+    lev_idx_list.reserve(lp_list.size());
+    for (const auto &lay_purp_vec : lp_list) {
+        lev_idx_list.push_back(lay_purp_vec.empty() ? npos : get_index(lay_purp_vec[0]));
+    }
+}
+
+std::size_t rule_table::get_index(layer_t key) const noexcept {
+    auto iter = std::lower_bound(key_list.begin(), key_list.end(), key);
+    return (iter == key_list.end() || *iter != key)
+               ? npos
+               : static_cast<std::size_t>(iter - key_list.begin());
+}
+
+std::size_t rule_table::get_level_index(std::size_t lev_idx) const noexcept {
+    return (lev_idx < lev_idx_list.size()) ? lev_idx_list[lev_idx] : npos;
+}
+
+offset_t rule_table::get_min_space(std::size_t idx, offset_t width, space_type sp_type,
+                                   bool even) const {
+    auto sp_idx = static_cast<std::size_t>(sp_type);
+    if (sp_idx >= num_sp_types || !sp_defined[sp_idx])
+        throw std::out_of_range("Min space not defined for space type: " +
+                                std::to_string(static_cast<enum_t>(sp_type)));
+    if (idx == npos)
+        return 0;
+    const auto &table = sp_tables[sp_idx];
+    auto start = table.offsets[idx];
+    auto n = table.offsets[idx + 1] - start;
+    if (n == 0)
+        return 0;
+    // the last breakpoint is always the maximum offset, so the search never runs off the end
+    auto sp = table.val_list[start +
+                             helper::lower_bound_index(table.w_list.data() + start, n, width)];
+    return sp + (sp & static_cast<offset_t>(even));
+}
+
+offset_t rule_table::get_min_length(std::size_t idx, offset_t width, bool even) const noexcept {
+    if (idx == npos)
+        return 0;
+
+    offset_t ans = 0;
+    auto start = len_w_table.offsets[idx];
+    auto n = len_w_table.offsets[idx + 1] - start;
+    auto w_idx = helper::lower_bound_index(len_w_table.w_list.data() + start, n, width);
+    if (w_idx < n) {
+        const auto &[w_spec, area, min_len] = len_w_table.val_list[start + w_idx];
+        ans = std::max(min_len, util::ceil(area, width));
+    }
+
+    for (auto md_idx = len_md_offsets[idx], stop = len_md_offsets[idx + 1]; md_idx < stop;
+         ++md_idx) {
+        const auto &[max_dim, area, min_len] = len_md_list[md_idx];
+        if (std::max(width, ans) > max_dim)
+            break;
+        ans = std::max({ans, min_len, util::ceil(area, width)});
+    }
+    return ans + (ans & static_cast<offset_t>(even));
+}
+
+} // namespace layout
+} // namespace cbag
@@ -53,19 +53,19 @@ tech::tech(const std::string &tech_fname) {
     vlookup = via_lookup(node, lp_map);
 
     // populate space map
-    sp_map_grp.emplace(space_type::DIFF_COLOR, make_space_map(node["sp_min"], lp_map));
-    sp_map_grp.emplace(space_type::LINE_END, make_space_map(node["sp_le_min"], lp_map));
-
-    auto sp_sc_node = node["sp_sc_min"];
-    if (sp_sc_node.IsDefined()) {
-        sp_map_grp.emplace(space_type::SAME_COLOR, make_space_map(sp_sc_node, lp_map));
-        sp_sc_type = space_type::SAME_COLOR;
-    } else {
-        sp_sc_type = space_type::DIFF_COLOR;
+    sp_map_grp_t sp_map_grp;
+    // space types without a section stay undefined, so queries of them throw
+    for (const auto &[sp_type, sp_name] : {std::make_pair(space_type::DIFF_COLOR, "sp_min"),
+                                           std::make_pair(space_type::LINE_END, "sp_le_min"),
+                                           std::make_pair(space_type::SAME_COLOR, "sp_sc_min")}) {
+        auto sp_node = node[sp_name];
+        if (sp_node.IsDefined()) {
+            sp_map_grp.emplace(sp_type, make_space_map(sp_node, lp_map));
+        }
     }
 
     // populate len_map
-    len_map = make_len_map(node["len_min"], lp_map);
+    auto len_map = make_len_map(node["len_min"], lp_map);
 
     // get level-to-layer/purpose mapping
     auto tmp = cbagyaml::int_map_to_vec<std::vector<std::pair<std::string, std::string>>>(
@@ -97,6 +97,9 @@ tech::tech(const std::string &tech_fname) {
         }
         ++lay;
     }
+
+    // compile space and length rules
+    rules = rule_table(sp_map_grp, len_map, lp_list);
 }
 
 const std::string &tech::get_tech_lib() const { return tech_lib; }
@@ -129,6 +132,11 @@ std::optional<purp_t> tech::get_purpose_id(const std::string &purpose) const {
     return lp_map.get_purpose_id(purpose);
 }
 
+std::vector<std::pair<const std::string *, const std::string *>>
+tech::get_lay_purp_names(const std::vector<layer_t> &key_list) const {
+    return lp_map.get_names(key_list);
+}
+
 std::optional<level_t> tech::get_level(layer_t key) const {
     std::optional<level_t> ans;
     auto iter = lev_map.find(key);
@@ -145,48 +153,66 @@ const std::vector<layer_t> &tech::get_lay_purp_list(level_t level) const {
     return lp_list[idx];
 }
 
-offset_t tech::get_min_space(layer_t key, offset_t width, space_type sp_type, bool even) const {
-    auto map_iter = sp_map_grp.find((sp_type == space_type::SAME_COLOR) ? sp_sc_type : sp_type);
-    if (map_iter == sp_map_grp.end())
-        throw std::out_of_range("Min space not defined forspace type: " +
-                                std::to_string(static_cast<enum_t>(sp_type)));
+std::size_t tech::get_num_colors(level_t level) const noexcept {
+    auto idx = static_cast<std::size_t>(level - grid_bot_layer);
+    return (idx < lp_list.size()) ? lp_list[idx].size() : 0;
+}
 
-    const auto &cur_map = map_iter->second;
-    auto vec_iter = cur_map.find(key);
-    if (vec_iter == cur_map.end())
-        return 0;
+std::size_t tech::get_rule_index(level_t level) const {
+    auto idx = static_cast<std::size_t>(level - grid_bot_layer);
+    if (idx >= lp_list.size())
+        throw std::out_of_range("Undefined routing grid level: " + std::to_string(level));
+    return rules.get_level_index(idx);
+}
 
-    const auto &w_sp_list = vec_iter->second;
+offset_t tech::get_min_space(layer_t key, offset_t width, space_type sp_type, bool even) const {
+    return rules.get_min_space(rules.get_index(key), width, sp_type, even);
+}
 
-    for (const auto &[w_spec, sp] : w_sp_list) {
-        if (width <= w_spec)
-            return sp + (sp & static_cast<offset_t>(even));
-    }
-    auto ans = w_sp_list[w_sp_list.size() - 1].second;
-    return ans + (ans & static_cast<offset_t>(even));
+offset_t tech::get_min_space(level_t level, offset_t width, space_type sp_type, bool even) const {
+    return rules.get_min_space(get_rule_index(level), width, sp_type, even);
 }
 
 offset_t tech::get_min_length(layer_t key, offset_t width, bool even) const {
-    auto iter = len_map.find(key);
-    if (iter == len_map.end())
-        return 0;
+    return rules.get_min_length(rules.get_index(key), width, even);
+}
+
+offset_t tech::get_min_length(level_t level, offset_t width, bool even) const {
+    return rules.get_min_length(get_rule_index(level), width, even);
+}
+
+const rule_table &tech::get_rule_table() const noexcept { return rules; }
 
-    return iter->second.get_min_length(width, even);
+via_def_t tech::get_via_def(direction vdir, layer_t layer, layer_t adj_layer) const {
+    return vlookup.get_via_def(vdir, layer, adj_layer);
 }
 
 const std::string &tech::get_via_id(direction vdir, layer_t layer, layer_t adj_layer) const {
     return vlookup.get_via_id(vdir, layer, adj_layer);
 }
 
+via_lay_purp_t tech::get_via_layer_purpose(via_def_t vdef) const {
+    return vlookup.get_via_layer_purpose(vdef);
+}
+
 via_lay_purp_t tech::get_via_layer_purpose(const std::string &key) const {
     return vlookup.get_via_layer_purpose(key);
 }
 
+via_param tech::get_via_param(vector dim, via_def_t vdef, direction vdir, orient_2d ex_dir,
+                              orient_2d adj_ex_dir, bool extend) const {
+    return vlookup.get_via_param(dim, vdef, vdir, ex_dir, adj_ex_dir, extend);
+}
+
 via_param tech::get_via_param(vector dim, const std::string &via_id, direction vdir,
                               orient_2d ex_dir, orient_2d adj_ex_dir, bool extend) const {
     return vlookup.get_via_param(dim, via_id, vdir, ex_dir, adj_ex_dir, extend);
 }
 
+const via_param_cache &tech::get_via_param_cache() const noexcept {
+    return vlookup.get_via_param_cache();
+}
+
 em_specs_t tech::get_metal_em_specs(const std::string &layer, const std::string &purpose,
                                     offset_t width, offset_t length, bool vertical, temp_t dc_temp,
                                     temp_t rms_dt) const {
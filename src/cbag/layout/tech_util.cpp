@@ -59,17 +59,15 @@ offset_t get_min_length(const tech &t, const std::string &layer, const std::stri
 
 offset_t get_min_length(const tech &t, level_t level, const wire_width &wire_w, bool even) {
     offset_t ans = 0;
-    auto key = get_test_lay_purp(t, level);
     for (auto witer = wire_w.begin_width(), wend = wire_w.end_width(); witer != wend; ++witer) {
-        ans = std::max(ans, t.get_min_length(key, *witer, even));
+        ans = std::max(ans, t.get_min_length(level, *witer, even));
     }
     return ans;
 }
 
 offset_t get_min_space(const tech &t, level_t level, const wire_width &wire_w, space_type sp_type,
                        bool even) {
-    auto key = get_test_lay_purp(t, level);
-    return t.get_min_space(key, wire_w.get_edge_wire_width(), sp_type, even);
+    return t.get_min_space(level, wire_w.get_edge_wire_width(), sp_type, even);
 }
 
 em_specs_t get_metal_em_specs(const tech &t, layer_t key, offset_t width, offset_t length,
@@ -0,0 +1,116 @@
+#include <fmt/core.h>
+
+#include <cbag/common/box_t_util.h>
+#include <cbag/enum/round_mode.h>
+#include <cbag/layout/routing_grid.h>
+#include <cbag/layout/track_info_util.h>
+#include <cbag/layout/track_occupancy.h>
+
+namespace cbag {
+namespace layout {
+
+struct track_occupancy::helper {
+    static std::size_t get_index(const track_occupancy &self, level_t level) {
+        auto idx = static_cast<std::size_t>(level - self.bot_level);
+        if (idx >= self.lev_list.size())
+            throw std::out_of_range("Undefined routing grid level: " + std::to_string(level));
+        return idx;
+    }
+
+    static const util::disjoint_intvs<> *find_track(const track_occupancy &self, level_t level,
+                                                    htr_t htr) {
+        const auto &htr_map = self.lev_list[get_index(self, level)];
+        auto iter = htr_map.find(htr);
+        return (iter == htr_map.end()) ? nullptr : &(iter->second);
+    }
+
+    static bool is_free(const util::disjoint_intvs<> *intvs, std::array<offset_t, 2> coord) {
+        return intvs == nullptr || !intvs->overlaps(coord);
+    }
+
+    static void check_step(htr_t step) {
+        if (step == 0)
+            throw std::invalid_argument("half-track step cannot be 0.");
+    }
+};
+
+track_occupancy::track_occupancy() = default;
+
+track_occupancy::track_occupancy(level_t bot_level, std::size_t num_levels)
+    : bot_level(bot_level), lev_list(num_levels) {}
+
+bool track_occupancy::operator==(const track_occupancy &rhs) const noexcept {
+    return bot_level == rhs.bot_level && lev_list == rhs.lev_list;
+}
+
+bool track_occupancy::empty() const noexcept {
+    for (const auto &htr_map : lev_list) {
+        if (!htr_map.empty())
+            return false;
+    }
+    return true;
+}
+
+void track_occupancy::clear(level_t level) { lev_list[helper::get_index(*this, level)].clear(); }
+
+void track_occupancy::add(const routing_grid &grid, level_t level, const box_t &box) {
+    auto &htr_map = lev_list[helper::get_index(*this, level)];
+    auto &tr_info = grid.track_info_at(level);
+    auto dir = tr_info.get_direction();
+    auto pdir = perpendicular(dir);
+    auto span = std::array<offset_t, 2>{lower(box, dir), upper(box, dir)};
+    if (span[0] >= span[1])
+        return;
+
+    // a half-track is blocked if a wire centered on it overlaps the box
+    auto half_w = tr_info.get_wire_span(1) / 2;
+    auto htr_lo = coord_to_htr(tr_info, lower(box, pdir) - half_w, round_mode::GREATER);
+    auto htr_hi = coord_to_htr(tr_info, upper(box, pdir) + half_w, round_mode::LESS);
+    for (auto htr = htr_lo; htr <= htr_hi; ++htr) {
+        htr_map[htr].emplace(true, true, span);
+    }
+}
+
+bool track_occupancy::is_free(level_t level, htr_t htr, std::array<offset_t, 2> coord) const {
+    return helper::is_free(helper::find_track(*this, level, htr), coord);
+}
+
+htr_t track_occupancy::get_next_free(level_t level, htr_t htr, std::array<offset_t, 2> coord,
+                                     htr_t step) const {
+    helper::check_step(step);
+    const auto &htr_map = lev_list[helper::get_index(*this, level)];
+    // only half-tracks in the map can be blocked, so this loop terminates
+    for (auto iter = htr_map.find(htr); iter != htr_map.end() && iter->second.overlaps(coord);
+         iter = htr_map.find(htr)) {
+        htr += step;
+    }
+    return htr;
+}
+
+std::vector<htr_t> track_occupancy::get_free_tracks(level_t level, htr_t start, htr_t stop,
+                                                    std::array<offset_t, 2> coord,
+                                                    htr_t step) const {
+    helper::check_step(step);
+    const auto &htr_map = lev_list[helper::get_index(*this, level)];
+    std::vector<htr_t> ans;
+    for (auto htr = start; (step > 0) ? htr < stop : htr > stop; htr += step) {
+        auto iter = htr_map.find(htr);
+        if (iter == htr_map.end() || !iter->second.overlaps(coord))
+            ans.push_back(htr);
+    }
+    return ans;
+}
+
+std::vector<std::array<offset_t, 2>>
+track_occupancy::get_blocked_spans(level_t level, htr_t htr, std::array<offset_t, 2> coord) const {
+    std::vector<std::array<offset_t, 2>> ans;
+    auto intvs = helper::find_track(*this, level, htr);
+    if (intvs != nullptr) {
+        auto [start_iter, stop_iter] = intvs->overlap_range(coord);
+        ans.insert(ans.end(), start_iter, stop_iter);
+    }
+    return ans;
+}
+
+} // namespace layout
+} // namespace cbag
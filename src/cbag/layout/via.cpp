@@ -25,15 +25,20 @@ struct via::helper {
 
 via::via() = default;
 
-via::via(cbag::transformation xform, std::string via_id, via_param params)
-    : via_id(std::move(via_id)), params(std::move(params)), xform(std::move(xform)) {}
+via::via(cbag::transformation xform, via_def_t vdef, via_param params)
+    : vdef(vdef), params(std::move(params)), xform(std::move(xform)) {}
 
-const std::string &via::get_via_id() const { return via_id; }
+via::via(cbag::transformation xform, const std::string &via_id, via_param params)
+    : via(std::move(xform), intern_via_id(via_id), std::move(params)) {}
+
+via_def_t via::get_via_def() const noexcept { return vdef; }
+
+const std::string &via::get_via_id() const { return get_via_id_str(vdef); }
 
 const via_param &via::get_params() const { return params; }
 
 bool via::operator==(const via &rhs) const noexcept {
-    return via_id == rhs.via_id && params == rhs.params && xform == rhs.xform;
+    return vdef == rhs.vdef && params == rhs.params && xform == rhs.xform;
 }
 
 } // namespace layout
@@ -0,0 +1,21 @@
+#include <cbag/common/transformation_util.h>
+#include <cbag/layout/via_array.h>
+
+namespace cbag {
+namespace layout {
+
+via_array::via_array() = default;
+
+via_array::via_array(via base, cnt_t nx, cnt_t ny, offset_t spx, offset_t spy)
+    : base(std::move(base)), nx(nx), ny(ny), spx(spx), spy(spy) {}
+
+bool via_array::operator==(const via_array &rhs) const noexcept {
+    return base == rhs.base && nx == rhs.nx && ny == rhs.ny && spx == rhs.spx && spy == rhs.spy;
+}
+
+via via_array::get_via(cnt_t ix, cnt_t iy) const {
+    return {get_move_by(base.xform, ix * spx, iy * spy), base.get_via_def(), base.get_params()};
+}
+
+} // namespace layout
+} // namespace cbag
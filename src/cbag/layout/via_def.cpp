@@ -0,0 +1,64 @@
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fmt/core.h>
+
+#include <cbag/layout/via_def.h>
+
+namespace cbag {
+namespace layout {
+
+struct via_id_table {
+    std::shared_mutex lock;
+    // a deque never moves its elements, so references to names stay valid
+    std::deque<std::string> name_list;
+    std::unordered_map<std::string, via_def_t> id_map;
+};
+
+via_id_table &get_via_id_table() {
+    static via_id_table table;
+    return table;
+}
+
+via_def_t intern_via_id(const std::string &via_id) {
+    auto &table = get_via_id_table();
+    {
+        std::shared_lock guard(table.lock);
+        auto iter = table.id_map.find(via_id);
+        if (iter != table.id_map.end())
+            return iter->second;
+    }
+    std::unique_lock guard(table.lock);
+    if (table.name_list.size() >= invalid_via_def)
+        throw std::length_error("Too many via definitions.");
+    auto [iter, inserted] =
+        table.id_map.emplace(via_id, static_cast<via_def_t>(table.name_list.size()));
+    if (inserted)
+        table.name_list.push_back(via_id);
+    return iter->second;
+}
+
+std::optional<via_def_t> find_via_def(const std::string &via_id) {
+    auto &table = get_via_id_table();
+    std::shared_lock guard(table.lock);
+    auto iter = table.id_map.find(via_id);
+    if (iter == table.id_map.end())
+        return {};
+    return iter->second;
+}
+
+const std::string &get_via_id_str(via_def_t vdef) {
+    if (vdef == invalid_via_def)
+        throw std::out_of_range("Via has no via definition.");
+    auto &table = get_via_id_table();
+    std::shared_lock guard(table.lock);
+    if (vdef >= table.name_list.size())
+        throw std::out_of_range(fmt::format("Undefined via definition handle: {}", vdef));
+    return table.name_list[vdef];
+}
+
+} // namespace layout
+} // namespace cbag
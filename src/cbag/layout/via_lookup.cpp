@@ -13,13 +13,29 @@
 namespace cbag {
 namespace layout {
 
-const std::vector<via_info> &via_info_at(const vinfo_map_t &info_map, const std::string &via_id) {
-    auto iter = info_map.find(via_id);
-    if (iter == info_map.end())
-        throw std::out_of_range("Cannot find via infor for via ID: " + via_id);
+struct via_lookup::helper {
+    static via_def_info &def_at(std::vector<via_def_info> &def_list, via_def_t vdef) {
+        if (vdef >= def_list.size())
+            def_list.resize(vdef + 1);
+        return def_list[vdef];
+    }
 
-    return iter->second;
-}
+    static const via_def_info *find_def(const via_lookup &self, via_def_t vdef) {
+        return (vdef < self.def_list.size()) ? &self.def_list[vdef] : nullptr;
+    }
+
+    static const via_def_info *find_def(const via_lookup &self, const std::string &via_id) {
+        auto vdef = find_via_def(via_id);
+        return (vdef) ? find_def(self, *vdef) : nullptr;
+    }
+
+    static const std::vector<via_info> &via_info_at(const via_lookup &self, via_def_t vdef) {
+        auto ptr = find_def(self, vdef);
+        if (ptr == nullptr || !ptr->info_list)
+            throw std::out_of_range("Cannot find via infor for via ID: " + get_via_id_str(vdef));
+        return *(ptr->info_list);
+    }
+};
 
 vlayers_t parse_via_layers(const YAML::Node &node, const lp_lookup &lp) {
     return {layer_t_at(lp, node[0][0].as<std::string>(), node[0][1].as<std::string>()),
@@ -28,26 +44,53 @@ vlayers_t parse_via_layers(const YAML::Node &node, const lp_lookup &lp) {
 
 via_lookup::via_lookup() = default;
 
-via_lookup::via_lookup(const YAML::Node &parent, const lp_lookup &lp)
-    : lp_map(parent["via_layers"].as<vlp_map_t>()), info_map(parent["via"].as<vinfo_map_t>()) {
+via_lookup::via_lookup(const YAML::Node &parent, const lp_lookup &lp) {
+    for (auto &[via_id, lay_purp] : parent["via_layers"].as<vlp_map_t>()) {
+        helper::def_at(def_list, intern_via_id(via_id)).lay_purp = lay_purp;
+    }
+    for (auto &[via_id, info_list] : parent["via"].as<vinfo_map_t>()) {
+        helper::def_at(def_list, intern_via_id(via_id)).info_list = std::move(info_list);
+    }
     for (const auto &node : parent["via_id"]) {
-        id_map.emplace(parse_via_layers(node.first, lp), node.second.as<std::string>());
+        id_map.emplace(parse_via_layers(node.first, lp),
+                       intern_via_id(node.second.as<std::string>()));
+    }
+
+    // precompute via solution tables, if specified
+    auto table_node = parent["via_table"];
+    if (table_node.IsDefined()) {
+        for (const auto &node : table_node) {
+            auto vdef = intern_via_id(node.first.as<std::string>());
+            auto dim_node = node.second["dim"];
+            std::array<std::vector<offset_t>, 2> dims = {
+                dim_node[0].as<std::vector<offset_t>>(), dim_node[1].as<std::vector<offset_t>>()};
+            auto table = via_table(std::move(dims), helper::via_info_at(*this, vdef));
+            helper::def_at(def_list, vdef).table = std::move(table);
+        }
+    }
+}
+
+via_lay_purp_t via_lookup::get_via_layer_purpose(via_def_t vdef) const {
+    auto ptr = helper::find_def(*this, vdef);
+    if (ptr == nullptr || !ptr->lay_purp) {
+        throw std::out_of_range(fmt::format("Cannot find via ID: {}", get_via_id_str(vdef)));
     }
+    return *(ptr->lay_purp);
 }
 
 via_lay_purp_t via_lookup::get_via_layer_purpose(const std::string &key) const {
-    auto iter = lp_map.find(key);
-    if (iter == lp_map.end()) {
+    auto ptr = helper::find_def(*this, key);
+    if (ptr == nullptr || !ptr->lay_purp) {
         throw std::out_of_range(fmt::format("Cannot find via ID: {}", key));
     }
-    return iter->second;
+    return *(ptr->lay_purp);
 }
 
 uint64_t get_via_score(const via_param &p) {
     return static_cast<uint64_t>(p.num[0]) * p.num[1] * p.cut_dim[0] * p.cut_dim[1];
 }
 
-const std::string &via_lookup::get_via_id(direction vdir, layer_t layer, layer_t adj_layer) const {
+via_def_t via_lookup::get_via_def(direction vdir, layer_t layer, layer_t adj_layer) const {
     vlayers_t key;
     auto dir_idx = to_int(vdir);
     key[dir_idx] = layer;
@@ -60,10 +103,13 @@ const std::string &via_lookup::get_via_id(direction vdir, layer_t layer, layer_t
     return iter->second;
 }
 
-via_param via_lookup::get_via_param(vector dim, const std::string &via_id, direction vdir,
-                                    orient_2d ex_dir, orient_2d adj_ex_dir, bool extend) const {
+const std::string &via_lookup::get_via_id(direction vdir, layer_t layer, layer_t adj_layer) const {
+    return get_via_id_str(get_via_def(vdir, layer, adj_layer));
+}
+
+via_param compute_via_param(const std::vector<via_info> &vinfo_list, vector dim, direction vdir,
+                            orient_2d ex_dir, orient_2d adj_ex_dir, bool extend) {
     auto adj_vdir = flip(vdir);
-    auto &vinfo_list = via_info_at(info_map, via_id);
     auto vidx = to_int(vdir);
     via_param ans;
     auto opt_score = static_cast<uint64_t>(0);
@@ -86,5 +132,46 @@ via_param via_lookup::get_via_param(vector dim, const std::string &via_id, direc
     return ans;
 }
 
+via_param via_lookup::get_via_param(vector dim, via_def_t vdef, direction vdir, orient_2d ex_dir,
+                                    orient_2d adj_ex_dir, bool extend) const {
+    auto ptr = helper::find_def(*this, vdef);
+    if (ptr != nullptr && ptr->table) {
+        auto param_ptr = ptr->table->find(dim, vdir, ex_dir, adj_ex_dir, extend);
+        if (param_ptr != nullptr)
+            return *param_ptr;
+    }
+
+    // off-table dimensions; fall back to search
+    via_query key{dim, vdef, vdir, ex_dir, adj_ex_dir, extend};
+    auto cached = cache->find(key);
+    if (cached)
+        return *cached;
+
+    auto ans =
+        compute_via_param(helper::via_info_at(*this, vdef), dim, vdir, ex_dir, adj_ex_dir, extend);
+    cache->insert(std::move(key), ans);
+    return ans;
+}
+
+via_param via_lookup::get_via_param(vector dim, const std::string &via_id, direction vdir,
+                                    orient_2d ex_dir, orient_2d adj_ex_dir, bool extend) const {
+    auto vdef = find_via_def(via_id);
+    if (!vdef)
+        throw std::out_of_range("Cannot find via infor for via ID: " + via_id);
+    return get_via_param(dim, *vdef, vdir, ex_dir, adj_ex_dir, extend);
+}
+
+const via_param_cache &via_lookup::get_via_param_cache() const noexcept { return *cache; }
+
+const via_table *via_lookup::get_via_table(via_def_t vdef) const {
+    auto ptr = helper::find_def(*this, vdef);
+    return (ptr == nullptr || !ptr->table) ? nullptr : &(*(ptr->table));
+}
+
+const via_table *via_lookup::get_via_table(const std::string &via_id) const {
+    auto vdef = find_via_def(via_id);
+    return (vdef) ? get_via_table(*vdef) : nullptr;
+}
+
 } // namespace layout
 } // namespace cbag
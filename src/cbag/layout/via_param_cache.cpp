@@ -0,0 +1,25 @@
+#include <boost/container_hash/hash.hpp>
+
+#include <cbag/layout/via_param_cache.h>
+
+namespace cbag {
+namespace layout {
+
+bool via_query::operator==(const via_query &rhs) const noexcept {
+    return dim == rhs.dim && vdef == rhs.vdef && vdir == rhs.vdir && ex_dir == rhs.ex_dir &&
+           adj_ex_dir == rhs.adj_ex_dir && extend == rhs.extend;
+}
+
+std::size_t via_query_hash::operator()(const via_query &v) const {
+    auto seed = boost::hash_value(v.vdef);
+    boost::hash_combine(seed, v.dim[0]);
+    boost::hash_combine(seed, v.dim[1]);
+    boost::hash_combine(seed, to_int(v.vdir));
+    boost::hash_combine(seed, to_int(v.ex_dir));
+    boost::hash_combine(seed, to_int(v.adj_ex_dir));
+    boost::hash_combine(seed, v.extend);
+    return seed;
+}
+
+} // namespace layout
+} // namespace cbag
@@ -0,0 +1,79 @@
+#include <algorithm>
+
+#include <cbag/layout/via_info.h>
+#include <cbag/layout/via_lookup.h>
+#include <cbag/layout/via_table.h>
+
+namespace cbag {
+namespace layout {
+
+struct via_table::helper {
+    // number of (vdir, ex_dir, adj_ex_dir, extend) combinations
+    static constexpr std::size_t num_flags = 16;
+
+    static std::size_t get_flag_index(direction vdir, orient_2d ex_dir, orient_2d adj_ex_dir,
+                                      bool extend) {
+        return (static_cast<std::size_t>(to_int(vdir)) << 3) |
+               (static_cast<std::size_t>(to_int(ex_dir)) << 2) |
+               (static_cast<std::size_t>(to_int(adj_ex_dir)) << 1) |
+               static_cast<std::size_t>(extend);
+    }
+
+    static std::size_t get_dim_index(const std::vector<offset_t> &vec, offset_t val) {
+        auto iter = std::lower_bound(vec.begin(), vec.end(), val);
+        if (iter == vec.end() || *iter != val)
+            return vec.size();
+        return iter - vec.begin();
+    }
+};
+
+via_table::via_table() = default;
+
+via_table::via_table(std::array<std::vector<offset_t>, 2> &&dims,
+                     const std::vector<via_info> &vinfo_list)
+    : dim_list(std::move(dims)) {
+    for (auto &vec : dim_list) {
+        std::sort(vec.begin(), vec.end());
+        vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+    }
+
+    auto nx = dim_list[0].size();
+    auto ny = dim_list[1].size();
+    table.resize(helper::num_flags * nx * ny);
+    for (auto vdir : {direction::LOWER, direction::UPPER}) {
+        for (auto ex_dir : {orient_2d::HORIZONTAL, orient_2d::VERTICAL}) {
+            for (auto adj_ex_dir : {orient_2d::HORIZONTAL, orient_2d::VERTICAL}) {
+                for (auto extend : {false, true}) {
+                    auto offset =
+                        helper::get_flag_index(vdir, ex_dir, adj_ex_dir, extend) * nx * ny;
+                    for (std::size_t ix = 0; ix < nx; ++ix) {
+                        for (std::size_t iy = 0; iy < ny; ++iy) {
+                            table[offset + ix * ny + iy] = compute_via_param(
+                                vinfo_list, vector{dim_list[0][ix], dim_list[1][iy]}, vdir,
+                                ex_dir, adj_ex_dir, extend);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::size_t via_table::size() const noexcept { return table.size(); }
+
+const via_param *via_table::find(vector dim, direction vdir, orient_2d ex_dir,
+                                 orient_2d adj_ex_dir, bool extend) const {
+    auto nx = dim_list[0].size();
+    auto ny = dim_list[1].size();
+    auto ix = helper::get_dim_index(dim_list[0], dim[0]);
+    if (ix == nx)
+        return nullptr;
+    auto iy = helper::get_dim_index(dim_list[1], dim[1]);
+    if (iy == ny)
+        return nullptr;
+    auto offset = helper::get_flag_index(vdir, ex_dir, adj_ex_dir, extend) * nx * ny;
+    return &table[offset + ix * ny + iy];
+}
+
+} // namespace layout
+} // namespace cbag
@@ -20,6 +20,7 @@
 #include <cbag/common/box_t_util.h>
 #include <cbag/common/transformation_util.h>
 #include <cbag/layout/cellview.h>
+#include <cbag/layout/cellview_util.h>
 #include <cbag/layout/instance.h>
 #include <cbag/layout/via.h>
 #include <cbag/schematic/cellview.h>
@@ -715,15 +716,17 @@ void write_lay_cellview(const oa::oaNativeNS &ns_native, const oa::oaCdbaNS &ns,
     }
 
     logger.info("Export layout geometries.");
+    // merge all layers concurrently, then create shapes in the usual order
+    cbag::layout::merge_geometry(cv);
     for (auto iter = cv.begin_geometry(); iter != cv.end_geometry(); ++iter) {
         auto &[layer_key, geo] = *iter;
         create_lay_geometry(logger, blk, layer_key.first, layer_key.second, geo);
     }
 
     logger.info("Export layout vias.");
-    for (auto iter = cv.begin_via(); iter != cv.end_via(); ++iter) {
-        create_lay_via(logger, blk, tech, *iter);
-    }
+    cv.for_each_via([&logger, &blk, &tech](const cbag::layout::via &v) {
+        create_lay_via(logger, blk, tech, v);
+    });
 
     logger.info("Export layout blockages.");
     oa::oaPointArray pt_arr;
@@ -0,0 +1,66 @@
+#include <cbag/util/parallel.h>
+
+namespace cbag {
+namespace util {
+
+namespace {
+thread_local bool is_pool_thread = false;
+} // namespace
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+    has_work.notify_all();
+    for (auto &t : workers) {
+        t.join();
+    }
+}
+
+thread_pool &thread_pool::get_instance() {
+    static thread_pool pool;
+    return pool;
+}
+
+bool thread_pool::in_worker() noexcept { return is_pool_thread; }
+
+std::size_t thread_pool::size() {
+    std::lock_guard<std::mutex> guard(lock);
+    return workers.size();
+}
+
+void thread_pool::reserve(std::size_t num_threads) {
+    std::lock_guard<std::mutex> guard(lock);
+    workers.reserve(num_threads);
+    while (workers.size() < num_threads) {
+        workers.emplace_back(&thread_pool::run_worker, this);
+    }
+}
+
+void thread_pool::submit(std::function<void()> &&task) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.emplace_back(std::move(task));
+    }
+    has_work.notify_one();
+}
+
+void thread_pool::run_worker() {
+    is_pool_thread = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            has_work.wait(guard, [this]() { return stop || !queue.empty(); });
+            if (queue.empty())
+                return;
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace util
+} // namespace cbag
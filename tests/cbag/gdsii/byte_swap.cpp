@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/gdsii/byte_swap.h>
+#include <cbag/gdsii/math.h>
+#include <cbag/gdsii/record_cursor.h>
+
+using simd_level = cbag::gdsii::simd_level;
+
+TEST_CASE("int32 array conversion matches scalar code", "[gds]") {
+    auto level = GENERATE(values<simd_level>({simd_level::SCALAR, simd_level::SSE2,
+                                              simd_level::AVX2}));
+    // sizes cover empty input, partial vectors, and unrolled loops with tails.
+    auto num = GENERATE(range<std::size_t>(0, 40));
+
+    std::mt19937 gen(static_cast<unsigned>(num));
+    std::uniform_int_distribution<int32_t> dist(std::numeric_limits<int32_t>::min(),
+                                                std::numeric_limits<int32_t>::max());
+    std::vector<int32_t> vals(num);
+    for (auto &v : vals)
+        v = dist(gen);
+
+    std::vector<char> bytes(4 * num + 1);
+    cbag::gdsii::encode_int32_array(vals.data(), bytes.data(), num, level);
+    for (std::size_t idx = 0; idx < num; ++idx) {
+        REQUIRE(cbag::gdsii::decode_int32(bytes.data() + 4 * idx) == vals[idx]);
+    }
+
+    // decode from an unaligned address
+    std::vector<char> shifted(4 * num + 1);
+    std::copy(bytes.begin(), bytes.begin() + 4 * num, shifted.begin() + 1);
+    std::vector<int32_t> ans(num + 1, 0);
+    cbag::gdsii::decode_int32_array(shifted.data() + 1, ans.data(), num, level);
+    ans.pop_back();
+    REQUIRE(ans == vals);
+}
+
+TEST_CASE("uint64 array conversion matches scalar code", "[gds]") {
+    auto level = GENERATE(values<simd_level>({simd_level::SCALAR, simd_level::SSE2,
+                                              simd_level::AVX2}));
+    auto num = GENERATE(range<std::size_t>(0, 20));
+
+    std::vector<uint64_t> vals(num);
+    for (std::size_t idx = 0; idx < num; ++idx)
+        vals[idx] = cbag::gdsii::double_to_gds(1.5e-3 * (idx + 1));
+
+    std::vector<char> bytes(8 * num);
+    cbag::gdsii::encode_uint64_array(vals.data(), bytes.data(), num, level);
+    for (std::size_t idx = 0; idx < num; ++idx) {
+        REQUIRE(cbag::gdsii::decode_bytes<uint64_t>(bytes.data() + 8 * idx) == vals[idx]);
+    }
+
+    std::vector<uint64_t> ans(num);
+    cbag::gdsii::decode_uint64_array(bytes.data(), ans.data(), num, level);
+    REQUIRE(ans == vals);
+}
+
+TEST_CASE("byte swap kernels throughput", "[.][benchmark][gds]") {
+    auto level = GENERATE(values<simd_level>({simd_level::SCALAR, simd_level::SSE2,
+                                              simd_level::AVX2}));
+    std::size_t num = 1 << 20;
+    int num_iter = 200;
+
+    std::vector<int32_t> vals(num);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int32_t> dist(-100000, 100000);
+    for (auto &v : vals)
+        v = dist(gen);
+    std::vector<char> bytes(4 * num);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int idx = 0; idx < num_iter; ++idx) {
+        cbag::gdsii::encode_int32_array(vals.data(), bytes.data(), num, level);
+        cbag::gdsii::decode_int32_array(bytes.data(), vals.data(), num, level);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count();
+    auto mb = 2.0 * num_iter * bytes.size() / (1 << 20);
+    WARN("level " << static_cast<int>(level) << " (cpu "
+                  << static_cast<int>(cbag::gdsii::get_simd_level()) << "): " << mb << " MiB in "
+                  << usec / 1000.0 << " ms, " << mb / (usec * 1e-6) << " MiB/s");
+}
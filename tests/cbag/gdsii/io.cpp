@@ -54,3 +54,32 @@ TEST_CASE("Read/write transformation objects", "[gds]") {
     auto ans = cbag::gdsii::read_transform(*logger, stream);
     REQUIRE(ans == xform);
 }
+
+TEST_CASE("write_buffer flushes in order when full", "[gds]") {
+    auto capacity = GENERATE(values<std::size_t>({1, 3, 8, 1024}));
+
+    std::stringstream expect;
+    std::stringstream stream;
+    {
+        cbag::gdsii::write_buffer buf(stream, capacity);
+        for (uint32_t idx = 0; idx < 100; ++idx) {
+            auto val = 0x01020304 * idx;
+            cbag::gdsii::write_bytes(expect, val);
+            buf.put(val);
+            cbag::gdsii::write_bytes(expect, static_cast<uint16_t>(idx));
+            buf.put(static_cast<uint16_t>(idx));
+        }
+        // claims larger than the capacity grow the buffer
+        auto ptr = buf.claim(2000);
+        for (std::size_t idx = 0; idx < 2000; ++idx) {
+            ptr[idx] = static_cast<char>(idx);
+            expect.put(static_cast<char>(idx));
+        }
+        buf.flush();
+        REQUIRE(buf.size() == 0);
+        REQUIRE(stream.str() == expect.str());
+        buf.put(static_cast<uint64_t>(0x0102030405060708));
+        cbag::gdsii::write_bytes(expect, static_cast<uint64_t>(0x0102030405060708));
+    }
+    REQUIRE(stream.str() == expect.str());
+}
@@ -0,0 +1,270 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/common/box_t.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/gdsii/read.h>
+#include <cbag/gdsii/record_cursor.h>
+#include <cbag/gdsii/struct_index.h>
+#include <cbag/gdsii/write.h>
+#include <cbag/gdsii/write_util.h>
+#include <cbag/layout/cellview.h>
+#include <cbag/layout/instance.h>
+#include <cbag/layout/routing_grid.h>
+#include <cbag/layout/tech_util.h>
+#include <cbag/util/io.h>
+
+using c_cv_ptr = std::unique_ptr<cbag::layout::cellview>;
+
+// writes a master cell with shapes, and a top cell with an instance and an array instance of the
+// master.  If reverse is true, the top cell is written first.
+void write_test_gds(const std::string &fname, const cbag::layout::routing_grid &grid,
+                    const cbag::gdsii::gds_lookup &lookup, bool reverse = false) {
+    auto &tech = *grid.get_tech();
+    auto logger = cbag::get_cbag_logger();
+    std::vector<cbag::gdsii::tval_t> time_vec{119, 1, 1, 0, 0, 0};
+    std::unordered_map<std::string, std::string> rename_map;
+
+    cbag::layout::cellview master(&grid, "CBAG_SUB");
+    for (const auto &lay : {"M1", "M2"}) {
+        auto key = cbag::layout::layer_t_at(tech, lay, "");
+        for (cbag::coord_t idx = 0; idx < 10; ++idx) {
+            master.add_shape(key, cbag::box_t(idx * 50, 0, idx * 50 + 20, 400));
+        }
+    }
+
+    cbag::layout::cellview top(&grid, "CBAG_TOP");
+    top.add_shape(cbag::layout::layer_t_at(tech, "M3", ""), cbag::box_t(0, 0, 1000, 40));
+    top.add_object(cbag::layout::instance("XM0", &master, cbag::make_xform(0, 1000, cbag::oMX)));
+    top.add_object(
+        cbag::layout::instance("XM1", &master, cbag::make_xform(0, 2000), 3, 2, 600, 500));
+
+    auto stream = cbag::util::open_file_write(fname, true);
+    cbag::gdsii::write_gds_start(*logger, stream, "CBAG_LIB", 1e-9, 1e-3, time_vec);
+    rename_map["CBAG_SUB"] = "CBAG_SUB";
+    if (reverse)
+        cbag::gdsii::write_lay_cellview(*logger, stream, "CBAG_TOP", top, rename_map, time_vec,
+                                        lookup);
+    cbag::gdsii::write_lay_cellview(*logger, stream, "CBAG_SUB", master, rename_map, time_vec,
+                                    lookup);
+    if (!reverse)
+        cbag::gdsii::write_lay_cellview(*logger, stream, "CBAG_TOP", top, rename_map, time_vec,
+                                        lookup);
+    cbag::gdsii::write_gds_stop(*logger, stream);
+    stream.close();
+}
+
+TEST_CASE("record_cursor decodes records in place", "[gds]") {
+    auto logger = cbag::get_cbag_logger();
+    std::stringstream stream;
+    cbag::gdsii::write_struct_name(*logger, stream, "ABC");
+    cbag::gdsii::write_box(*logger, stream, 3, 4, cbag::box_t(0, 0, 10, 20));
+    cbag::gdsii::write_struct_end(*logger, stream);
+
+    cbag::gdsii::record_cursor cursor(stream);
+    REQUIRE(!cursor.is_mapped());
+    REQUIRE(cursor.size() == stream.str().size());
+
+    // peek does not advance the cursor
+    REQUIRE(cursor.peek().type == cbag::gdsii::record_type::STRNAME);
+    REQUIRE(cursor.tell() == 0);
+    auto name = cursor.next(cbag::gdsii::record_type::STRNAME);
+    // names keep their padding byte
+    REQUIRE(name.get_string() == std::string("ABC\0", 4));
+
+    REQUIRE_THROWS_AS(cursor.next(cbag::gdsii::record_type::LAYER), std::runtime_error);
+    cursor.seek(name.size + 4);
+    REQUIRE(cursor.next().type == cbag::gdsii::record_type::BOX);
+    REQUIRE(cursor.next(cbag::gdsii::record_type::LAYER, 2, 1).get_uint16() == 3);
+    REQUIRE(cursor.next(cbag::gdsii::record_type::BOXTYPE, 2, 1).get_uint16() == 4);
+    auto xy = cursor.next(cbag::gdsii::record_type::XY, 8, 5).get_xy();
+    REQUIRE(xy[2] == cbag::point{10, 20});
+    REQUIRE(cursor.next().type == cbag::gdsii::record_type::ENDEL);
+    REQUIRE(cursor.next().type == cbag::gdsii::record_type::ENDSTR);
+    REQUIRE(cursor.at_end());
+    REQUIRE_THROWS_AS(cursor.next(), std::runtime_error);
+    REQUIRE_THROWS_AS(cursor.seek(cursor.size() + 1), std::out_of_range);
+}
+
+TEST_CASE("record_cursor decodes XY records", "[gds]") {
+    std::vector<char> data{0, 20, 0x10, 0x03, 0, 0, 0, 5, -1, -1, -1, -6, 0x7f, -1, -1, -1,
+                           -128, 0, 0, 0};
+    cbag::gdsii::record_cursor cursor(std::move(data));
+    auto xy = cursor.next(cbag::gdsii::record_type::XY, 8).get_xy();
+    REQUIRE(xy.size() == 2);
+    REQUIRE(xy[0] == cbag::point{5, -6});
+    REQUIRE(xy[1] == cbag::point{INT32_MAX, INT32_MIN});
+}
+
+TEST_CASE("read_gds gives the same cellviews with and without mmap", "[gds]") {
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    std::string lay_map = "tests/data/test_gds/gds.layermap";
+    std::string obj_map = "tests/data/test_gds/gds.objectmap";
+    cbag::gdsii::gds_lookup lookup(tech, lay_map, obj_map);
+    std::string fname = "tests/data/test_outputs/gds/read_test.gds";
+    write_test_gds(fname, grid, lookup);
+
+    std::vector<c_cv_ptr> cv_list;
+    cbag::gdsii::read_gds(fname, lay_map, obj_map, grid, std::back_inserter(cv_list));
+    REQUIRE(cv_list.size() == 2);
+    REQUIRE(cv_list[0]->get_name() == "CBAG_SUB");
+    REQUIRE(cv_list[1]->get_name() == "CBAG_TOP");
+    REQUIRE(!cv_list[0]->empty());
+    REQUIRE(std::distance(cv_list[1]->begin_inst(), cv_list[1]->end_inst()) == 2);
+    for (auto iter = cv_list[1]->begin_inst(); iter != cv_list[1]->end_inst(); ++iter) {
+        REQUIRE(iter->second.get_cellview() == cv_list[0].get());
+    }
+
+#if __has_include(<sys/mman.h>)
+    REQUIRE(cbag::gdsii::record_cursor(fname).is_mapped());
+#endif
+
+    // buffered fallback
+    auto logger = cbag::get_cbag_logger();
+    cbag::gdsii::gds_rlookup rmap(lay_map, obj_map, tech);
+    cbag::gdsii::record_cursor cursor(fname, false);
+    REQUIRE(!cursor.is_mapped());
+    auto lib_name = cbag::gdsii::read_gds_start(*logger, cursor);
+    REQUIRE(lib_name == "CBAG_LIB");
+
+    // stream reader
+    auto stream = cbag::util::open_file_read(fname, true);
+    REQUIRE(cbag::gdsii::read_gds_start(*logger, stream) == lib_name);
+
+    std::vector<c_cv_ptr> cv_list2;
+    std::unordered_map<std::string, cbag::layout::cellview *> cv_map;
+    for (const auto &cv_expect : cv_list) {
+        REQUIRE(cursor.next().type == cbag::gdsii::record_type::BGNSTR);
+        auto [cell_name, cv_ptr] =
+            cbag::gdsii::read_lay_cellview(*logger, cursor, lib_name, grid, rmap, cv_map);
+        REQUIRE(cell_name == cv_expect->get_name());
+        REQUIRE(cv_ptr->content_equal(*cv_expect));
+
+        REQUIRE(std::get<0>(cbag::gdsii::read_record_header(stream)) ==
+                cbag::gdsii::record_type::BGNSTR);
+        stream.ignore(24);
+        auto [cell_name2, cv_ptr2] =
+            cbag::gdsii::read_lay_cellview(*logger, stream, lib_name, grid, rmap, cv_map);
+        REQUIRE(cell_name2 == cell_name);
+        REQUIRE(cv_ptr2->content_equal(*cv_expect));
+
+        cv_map.emplace(cell_name, cv_ptr.get());
+        cv_list2.push_back(std::move(cv_ptr));
+    }
+    REQUIRE(cursor.next().type == cbag::gdsii::record_type::ENDLIB);
+    REQUIRE(cursor.at_end());
+}
+
+TEST_CASE("read_gds reads structures in dependency order", "[gds]") {
+    auto num_workers = GENERATE(values<std::size_t>({0, 1, 2, 8}));
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    std::string lay_map = "tests/data/test_gds/gds.layermap";
+    std::string obj_map = "tests/data/test_gds/gds.objectmap";
+    cbag::gdsii::gds_lookup lookup(tech, lay_map, obj_map);
+    std::string fname = "tests/data/test_outputs/gds/read_test_reverse.gds";
+    write_test_gds(fname, grid, lookup, true);
+
+    auto logger = cbag::get_cbag_logger();
+    cbag::gdsii::record_cursor cursor(fname);
+    cbag::gdsii::struct_index index(*logger, cursor);
+    REQUIRE(cursor.tell() == 0);
+    REQUIRE(index.get_lib_name() == "CBAG_LIB");
+    REQUIRE(index.size() == 2);
+    REQUIRE(index.find("CBAG_TOP") == 0);
+    REQUIRE(index.find("CBAG_SUB") == 1);
+    REQUIRE(index.find("CBAG_NONE") == cbag::gdsii::struct_index::npos);
+    REQUIRE(index[0].deps == std::vector<std::size_t>{1});
+    REQUIRE(index[1].deps.empty());
+    REQUIRE(index[0].stop == index[1].start - 28);
+    auto waves = index.get_waves();
+    REQUIRE(waves == std::vector<std::vector<std::size_t>>{{1}, {0}});
+
+    // cellviews come out in file order, and match those of a file in dependency order.
+    std::vector<c_cv_ptr> cv_list;
+    cbag::gdsii::read_gds(fname, lay_map, obj_map, grid, std::back_inserter(cv_list),
+                          num_workers);
+    REQUIRE(cv_list.size() == 2);
+    REQUIRE(cv_list[0]->get_name() == "CBAG_TOP");
+    REQUIRE(cv_list[1]->get_name() == "CBAG_SUB");
+    for (auto iter = cv_list[0]->begin_inst(); iter != cv_list[0]->end_inst(); ++iter) {
+        REQUIRE(iter->second.get_cellview() == cv_list[1].get());
+    }
+
+    std::string fname_expect = "tests/data/test_outputs/gds/read_test.gds";
+    write_test_gds(fname_expect, grid, lookup);
+    std::vector<c_cv_ptr> cv_expect;
+    cbag::gdsii::read_gds(fname_expect, lay_map, obj_map, grid, std::back_inserter(cv_expect), 1);
+    REQUIRE(cv_list[0]->content_equal(*cv_expect[1]));
+    REQUIRE(cv_list[1]->content_equal(*cv_expect[0]));
+}
+
+TEST_CASE("read_gds_cell reads only the hierarchy of one cell", "[gds]") {
+    auto num_workers = GENERATE(values<std::size_t>({1, 4}));
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    std::string lay_map = "tests/data/test_gds/gds.layermap";
+    std::string obj_map = "tests/data/test_gds/gds.objectmap";
+    cbag::gdsii::gds_lookup lookup(tech, lay_map, obj_map);
+    auto logger = cbag::get_cbag_logger();
+    std::vector<cbag::gdsii::tval_t> time_vec{119, 1, 1, 0, 0, 0};
+    std::unordered_map<std::string, std::string> rename_map;
+
+    // CBAG_TOP -> CBAG_MID -> CBAG_SUB, and two cells outside that hierarchy.
+    auto m1 = cbag::layout::layer_t_at(tech, "M1", "");
+    cbag::layout::cellview sub(&grid, "CBAG_SUB");
+    sub.add_shape(m1, cbag::box_t(0, 0, 100, 20));
+    cbag::layout::cellview mid(&grid, "CBAG_MID");
+    mid.add_object(cbag::layout::instance("XS", &sub, cbag::make_xform(0, 0)));
+    cbag::layout::cellview top(&grid, "CBAG_TOP");
+    top.add_object(cbag::layout::instance("XM", &mid, cbag::make_xform(0, 100), 2, 1, 200, 0));
+    top.add_object(cbag::layout::instance("XS", &sub, cbag::make_xform(0, 300)));
+    cbag::layout::cellview pad(&grid, "CBAG_PAD");
+    pad.add_shape(m1, cbag::box_t(0, 0, 500, 500));
+    cbag::layout::cellview alt(&grid, "CBAG_ALT");
+    alt.add_object(cbag::layout::instance("XP", &pad, cbag::make_xform(0, 0)));
+    alt.add_object(cbag::layout::instance("XS", &sub, cbag::make_xform(0, 0)));
+
+    std::string fname = "tests/data/test_outputs/gds/read_cell_test.gds";
+    {
+        auto stream = cbag::util::open_file_write(fname, true);
+        cbag::gdsii::write_gds_start(*logger, stream, "CBAG_LIB", 1e-9, 1e-3, time_vec);
+        for (auto cv_ptr : {&pad, &top, &sub, &alt, &mid}) {
+            rename_map[cv_ptr->get_name()] = cv_ptr->get_name();
+            cbag::gdsii::write_lay_cellview(*logger, stream, cv_ptr->get_name(), *cv_ptr,
+                                            rename_map, time_vec, lookup);
+        }
+        cbag::gdsii::write_gds_stop(*logger, stream);
+    }
+
+    // files read back have polygons instead of boxes, so compare with a full read.
+    std::vector<c_cv_ptr> cv_expect;
+    cbag::gdsii::read_gds(fname, lay_map, obj_map, grid, std::back_inserter(cv_expect));
+    REQUIRE(cv_expect.size() == 5);
+
+    std::vector<c_cv_ptr> cv_list;
+    cbag::gdsii::read_gds_cell(fname, "CBAG_TOP", lay_map, obj_map, grid,
+                               std::back_inserter(cv_list), num_workers);
+    REQUIRE(cv_list.size() == 3);
+    REQUIRE(cv_list[0]->get_name() == "CBAG_TOP");
+    REQUIRE(cv_list[1]->get_name() == "CBAG_SUB");
+    REQUIRE(cv_list[2]->get_name() == "CBAG_MID");
+    REQUIRE(cv_list[0]->content_equal(*cv_expect[1]));
+    REQUIRE(cv_list[1]->content_equal(*cv_expect[2]));
+    REQUIRE(cv_list[2]->content_equal(*cv_expect[4]));
+
+    cv_list.clear();
+    cbag::gdsii::read_gds_cell(fname, "CBAG_PAD", lay_map, obj_map, grid,
+                               std::back_inserter(cv_list), num_workers);
+    REQUIRE(cv_list.size() == 1);
+    REQUIRE(cv_list[0]->content_equal(*cv_expect[0]));
+
+    REQUIRE_THROWS_AS(cbag::gdsii::read_gds_cell(fname, "CBAG_NONE", lay_map, obj_map, grid,
+                                                 std::back_inserter(cv_list), num_workers),
+                      std::runtime_error);
+}
@@ -0,0 +1,132 @@
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/common/box_t.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/gdsii/write.h>
+#include <cbag/layout/cellview.h>
+#include <cbag/layout/cellview_util.h>
+#include <cbag/layout/routing_grid.h>
+#include <cbag/layout/tech_util.h>
+#include <cbag/layout/via_wrapper.h>
+
+void draw_layers(cbag::layout::cellview &cv) {
+    auto &tech = *cv.get_tech();
+    for (const auto &lay : {"M1", "M2", "M3", "M4"}) {
+        auto key = cbag::layout::layer_t_at(tech, lay, "");
+        for (cbag::coord_t idx = 0; idx < 20; ++idx) {
+            cv.add_shape(key, cbag::box_t(idx * 50, 0, idx * 50 + 60, 1000));
+            cv.add_shape(key, cbag::box_t(0, idx * 200, 2000, idx * 200 + 20));
+        }
+    }
+}
+
+TEST_CASE("write_lay_cellview does not depend on number of workers", "[gds]") {
+    auto num_workers = GENERATE(values<std::size_t>({0, 2, 3, 8}));
+
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    cbag::gdsii::gds_lookup lookup(tech, "tests/data/test_gds/gds.layermap",
+                                   "tests/data/test_gds/gds.objectmap");
+    auto logger = cbag::get_cbag_logger();
+    std::vector<cbag::gdsii::tval_t> time_vec{119, 1, 1, 0, 0, 0};
+    std::unordered_map<std::string, std::string> rename_map;
+
+    cbag::layout::cellview cv_expect(&grid, "CBAG_TEST");
+    draw_layers(cv_expect);
+    std::stringstream expect;
+    cbag::gdsii::write_lay_cellview(*logger, expect, "CBAG_TEST", cv_expect, rename_map, time_vec,
+                                    lookup, 1);
+
+    cbag::layout::cellview cv(&grid, "CBAG_TEST");
+    draw_layers(cv);
+    std::stringstream ans;
+    cbag::gdsii::write_lay_cellview(*logger, ans, "CBAG_TEST", cv, rename_map, time_vec, lookup,
+                                    num_workers);
+
+    REQUIRE(expect.str().size() > 0);
+    REQUIRE(ans.str() == expect.str());
+}
+
+TEST_CASE("write_lay_cellview expands via arrays", "[gds]") {
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    cbag::gdsii::gds_lookup lookup(tech, "tests/data/test_gds/gds.layermap",
+                                   "tests/data/test_gds/gds.objectmap");
+    auto logger = cbag::get_cbag_logger();
+    std::vector<cbag::gdsii::tval_t> time_vec{119, 1, 1, 0, 0, 0};
+    std::unordered_map<std::string, std::string> rename_map;
+
+    auto l1 = cbag::layout::layer_t_at(tech, "M1", "");
+    auto l2 = cbag::layout::layer_t_at(tech, "M2", "");
+    auto via_id = tech.get_via_id(cbag::direction::LOWER, l1, l2);
+    cbag::layout::via_param params(1, 1, 32, 32, 0, 0, 14, 14, 14, 14, 14, 14, 14, 14);
+
+    cbag::layout::cellview cv_expect(&grid, "CBAG_TEST");
+    for (cbag::coord_t dx = 0; dx < 300; dx += 100) {
+        for (cbag::coord_t dy = 0; dy < 400; dy += 200) {
+            cv_expect.add_object(cbag::layout::via_wrapper(
+                cbag::layout::via(cbag::make_xform(dx, dy), via_id, params), false));
+        }
+    }
+    std::stringstream expect;
+    cbag::gdsii::write_lay_cellview(*logger, expect, "CBAG_TEST", cv_expect, rename_map, time_vec,
+                                    lookup);
+
+    cbag::layout::cellview cv(&grid, "CBAG_TEST");
+    cbag::layout::add_via_arr(cv, cbag::make_xform(0, 0), via_id, params, false, {3, 2},
+                              {100, 200});
+    REQUIRE(cv.begin_via() == cv.end_via());
+    REQUIRE(cv.end_via_arr() - cv.begin_via_arr() == 1);
+    std::stringstream ans;
+    cbag::gdsii::write_lay_cellview(*logger, ans, "CBAG_TEST", cv, rename_map, time_vec, lookup);
+
+    REQUIRE(ans.str() == expect.str());
+}
+
+TEST_CASE("write_lay_cellview keeps via array order", "[gds]") {
+    cbag::layout::tech tech("tests/data/test_layout/tech_params.yaml");
+    cbag::layout::routing_grid grid(&tech, "tests/data/test_layout/grid.yaml");
+    cbag::gdsii::gds_lookup lookup(tech, "tests/data/test_gds/gds.layermap",
+                                   "tests/data/test_gds/gds.objectmap");
+    auto logger = cbag::get_cbag_logger();
+    std::vector<cbag::gdsii::tval_t> time_vec{119, 1, 1, 0, 0, 0};
+    std::unordered_map<std::string, std::string> rename_map;
+
+    auto l1 = cbag::layout::layer_t_at(tech, "M1", "");
+    auto l2 = cbag::layout::layer_t_at(tech, "M2", "");
+    auto via_id = tech.get_via_id(cbag::direction::LOWER, l1, l2);
+    cbag::layout::via_param params(1, 1, 32, 32, 0, 0, 14, 14, 14, 14, 14, 14, 14, 14);
+    auto add_via = [&via_id, &params](cbag::layout::cellview &cv, cbag::coord_t x,
+                                      cbag::coord_t y) {
+        cv.add_object(cbag::layout::via_wrapper(
+            cbag::layout::via(cbag::make_xform(x, y), via_id, params), false));
+    };
+
+    cbag::layout::cellview cv_expect(&grid, "CBAG_TEST");
+    add_via(cv_expect, -500, 0);
+    for (cbag::coord_t dx = 0; dx < 200; dx += 100) {
+        add_via(cv_expect, dx, 0);
+    }
+    add_via(cv_expect, 500, 0);
+    for (cbag::coord_t dy = 0; dy < 400; dy += 200) {
+        add_via(cv_expect, 0, dy);
+    }
+    std::stringstream expect;
+    cbag::gdsii::write_lay_cellview(*logger, expect, "CBAG_TEST", cv_expect, rename_map, time_vec,
+                                    lookup);
+
+    cbag::layout::cellview cv(&grid, "CBAG_TEST");
+    add_via(cv, -500, 0);
+    cbag::layout::add_via_arr(cv, cbag::make_xform(0, 0), via_id, params, false, {2, 1},
+                              {100, 0});
+    add_via(cv, 500, 0);
+    cbag::layout::add_via_arr(cv, cbag::make_xform(0, 0), via_id, params, false, {1, 2},
+                              {0, 200});
+    REQUIRE(cv.end_via_arr() - cv.begin_via_arr() == 2);
+    std::stringstream ans;
+    cbag::gdsii::write_lay_cellview(*logger, ans, "CBAG_TEST", cv, rename_map, time_vec, lookup);
+
+    REQUIRE(ans.str() == expect.str());
+}
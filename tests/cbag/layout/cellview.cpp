@@ -119,6 +119,11 @@ TEST_CASE("add via", "[layout::cellview]") {
     REQUIRE(iter2 != iter_end);
     REQUIRE(iter1->second == expect1);
     REQUIRE(iter2->second == expect2);
+
+    // vias without a via definition are rejected
+    REQUIRE_THROWS_AS(cv.add_object(cbag::layout::via_wrapper(cbag::layout::via(), true)),
+                      std::invalid_argument);
+    REQUIRE(cv.end_via() - cv.begin_via() == 1);
 }
 
 TEST_CASE("add via on intersections", "[layout::cellview]") {
@@ -173,3 +178,181 @@ TEST_CASE("connect warr to track", "[layout::cellview]") {
 
     REQUIRE(ans == expect);
 }
+
+TEST_CASE("get hierarchical bounding box", "[layout::cellview]") {
+    auto tech_info = make_tech_info();
+    auto grid = make_grid(tech_info);
+    auto key = cbag::layout::layer_t_at(tech_info, "M2", "");
+
+    auto leaf = c_cellview(&grid, "CBAG_LEAF");
+    leaf.add_shape(key, c_box(0, 0, 100, 20));
+    auto mid = c_cellview(&grid, "CBAG_MID");
+    cbag::layout::add_instance(mid, &leaf, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    cbag::layout::add_instance(mid, &leaf, "X1", cbag::make_xform(0, 100, cbag::oR90), 1, 1, 0,
+                               0, true);
+    auto top = make_cv(grid);
+    cbag::layout::add_instance(top, &mid, "X0", cbag::make_xform(1000, 0), 1, 1, 0, 0, true);
+    cbag::layout::add_instance(top, &mid, "X1", cbag::make_xform(0, 0, cbag::oMY), 1, 1, 0, 0,
+                               true);
+
+    REQUIRE(mid.get_bbox(key) == c_box(-20, 0, 100, 200));
+    REQUIRE(cbag::layout::get_bbox(top, "M2", "") == c_box(-100, 0, 1100, 200));
+
+    // adding shapes invalidates the cached bounding box
+    top.add_shape(key, c_box(0, -50, 10, 0));
+    REQUIRE(top.get_bbox(key) == c_box(-100, -50, 1100, 200));
+}
+
+TEST_CASE("content hash", "[layout::cellview]") {
+    auto tech_info = make_tech_info();
+    auto grid = make_grid(tech_info);
+    auto k1 = cbag::layout::layer_t_at(tech_info, "M1", "");
+    auto k2 = cbag::layout::layer_t_at(tech_info, "M2", "");
+
+    auto cv1 = c_cellview(&grid, "CBAG_A");
+    auto cv2 = c_cellview(&grid, "CBAG_B");
+    REQUIRE(cv1.content_equal(cv2));
+    REQUIRE(!(cv1 == cv2));
+
+    // insertion order does not matter
+    cv1.add_shape(k1, c_box(0, 0, 100, 20));
+    cv1.add_shape(k2, c_box(0, 0, 20, 100));
+    cv2.add_shape(k2, c_box(0, 0, 20, 100));
+    REQUIRE(!cv1.content_equal(cv2));
+    cv2.add_shape(k1, c_box(0, 0, 100, 20));
+    REQUIRE(cv1.content_equal(cv2));
+    REQUIRE(cv1.get_hash() == cv2.get_hash());
+
+    // same shape on a different layer
+    auto cv3 = c_cellview(&grid, "CBAG_A");
+    cv3.add_shape(k2, c_box(0, 0, 100, 20));
+    cv3.add_shape(k1, c_box(0, 0, 20, 100));
+    REQUIRE(!cv1.content_equal(cv3));
+
+    // geometries are compared by the region they cover
+    auto cv4 = c_cellview(&grid, "CBAG_A");
+    auto cv5 = c_cellview(&grid, "CBAG_A");
+    cv4.add_shape(k1, c_box(0, 0, 20, 10));
+    cv5.add_shape(k1, c_box(0, 0, 10, 10));
+    cv5.add_shape(k1, c_box(10, 0, 20, 10));
+    REQUIRE(cv4 == cv5);
+    REQUIRE(cv4.get_hash() == cv5.get_hash());
+    cv4.add_shape(k1, c_box(0, 0, 20, 10));
+    REQUIRE(cv4 == cv5);
+    cv5.add_shape(k1, c_box(0, 0, 20, 20));
+    REQUIRE(!(cv4 == cv5));
+    REQUIRE(cv4.get_content_hash() != cv5.get_content_hash());
+
+    // shapes that only differ in their coordinates have different hashes
+    auto cv6 = c_cellview(&grid, "CBAG_A");
+    cv6.add_shape(k1, c_box(0, 0, 20, 10));
+    auto hash6 = cv6.get_content_hash();
+    cv6.add_shape(k1, c_box(40, 0, 60, 10));
+    REQUIRE(cv6.get_content_hash() != hash6);
+
+    // instances of identical masters are equal
+    auto top1 = make_cv(grid);
+    auto top2 = make_cv(grid);
+    cbag::layout::add_instance(top1, &cv1, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    cbag::layout::add_instance(top2, &cv1, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    REQUIRE(top1 == top2);
+    cbag::layout::add_instance(top1, &cv1, "X1", cbag::make_xform(0, 0, cbag::oR90), 1, 1, 0, 0,
+                               true);
+    cbag::layout::add_instance(top2, &cv1, "X1", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    REQUIRE(!(top1 == top2));
+
+    // distinct masters are compared by content
+    auto top3 = make_cv(grid);
+    auto top4 = make_cv(grid);
+    cbag::layout::add_instance(top3, &cv4, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    cbag::layout::add_instance(top4, &cv5, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    REQUIRE(!(top3 == top4));
+    auto top5 = make_cv(grid);
+    auto cv7 = c_cellview(&grid, "CBAG_A");
+    cv7.add_shape(k1, c_box(0, 0, 10, 10));
+    cv7.add_shape(k1, c_box(10, 0, 20, 10));
+    cbag::layout::add_instance(top5, &cv7, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    REQUIRE(top3 == top5);
+}
+
+TEST_CASE("track occupancy", "[layout::cellview]") {
+    using intv_list = std::vector<std::array<c_offset_t, 2>>;
+
+    auto tech_info = make_tech_info();
+    auto grid = make_grid(tech_info);
+    auto cv = make_cv(grid);
+    auto &occ = cv.get_track_occupancy();
+    REQUIRE(occ.empty());
+
+    // horizontal track at y = 60; margins are 64 along and 48 across the track
+    cbag::layout::add_warr(cv, c_warr(std::make_shared<c_tid>(4, 0, 1, 1, 0), 0, 100));
+    // the occupancy is only updated when requested
+    REQUIRE(occ.empty());
+    REQUIRE(&cv.get_track_occupancy() == &occ);
+    REQUIRE(!occ.empty());
+    REQUIRE(!occ.is_free(4, 0, {0, 100}));
+    REQUIRE(!occ.is_free(4, -1, {150, 300}));
+    REQUIRE(!occ.is_free(4, 1, {-100, -60}));
+    REQUIRE(occ.is_free(4, 0, {164, 300}));
+    REQUIRE(occ.is_free(4, 2, {0, 100}));
+    REQUIRE(occ.is_free(4, -2, {0, 100}));
+    REQUIRE(occ.is_free(3, 0, {0, 100}));
+    REQUIRE(occ.get_next_free(4, 0, {0, 100}) == 2);
+    REQUIRE(occ.get_next_free(4, 0, {0, 100}, -2) == -2);
+    REQUIRE(occ.get_next_free(4, -1, {0, 100}, 1) == 2);
+    REQUIRE(occ.get_free_tracks(4, -4, 6, {0, 100}) == std::vector<cbag::htr_t>{-4, -2, 2, 4});
+    REQUIRE(occ.get_blocked_spans(4, 0, {-1000, 1000}) == intv_list{{-64, 164}});
+
+    // a rectangle drawn on a routing layer is recorded as well
+    auto key = layer_t_at(tech_info, "M4", "drawing");
+    cv.add_shape(key, c_box(500, 30, 600, 90));
+    cv.get_track_occupancy();
+    REQUIRE(occ.get_blocked_spans(4, 0, {-1000, 1000}) == intv_list{{-64, 164}, {436, 664}});
+    REQUIRE(occ.get_blocked_spans(4, 0, {200, 400}).empty());
+    REQUIRE(occ.get_next_free(4, 0, {100, 500}) == 2);
+    REQUIRE(occ.get_next_free(4, 0, {200, 400}) == 0);
+
+    // rectangle arrays are recorded element by element
+    cbag::layout::add_rect_arr(cv, key, c_box(1000, 30, 1100, 90), {2, 1}, {300, 0});
+    cv.get_track_occupancy();
+    REQUIRE(occ.get_blocked_spans(4, 0, {700, 2000}) == intv_list{{936, 1164}, {1236, 1464}});
+
+    // shapes of instances are not recorded
+    auto leaf = c_cellview(&grid, "CBAG_LEAF");
+    leaf.add_shape(key, c_box(3000, 30, 3100, 90));
+    cbag::layout::add_instance(cv, &leaf, "X0", cbag::make_xform(0, 0), 1, 1, 0, 0, true);
+    cv.get_track_occupancy();
+    REQUIRE(occ.get_blocked_spans(4, 0, {2000, 4000}).empty());
+
+    REQUIRE_THROWS_AS(occ.is_free(100, 0, {0, 100}), std::out_of_range);
+    REQUIRE_THROWS_AS(occ.get_next_free(4, 0, {0, 100}, 0), std::invalid_argument);
+}
+
+TEST_CASE("add wire arrays in batch", "[layout::cellview]") {
+    auto tech_info = make_tech_info();
+    auto grid = make_grid(tech_info);
+    auto cv_ref = make_cv(grid);
+    auto cv = make_cv(grid);
+    auto hint = GENERATE(values<std::size_t>({0, 3, 100}));
+
+    auto warr_list = std::vector<c_warr>{
+        c_warr(std::make_shared<c_tid>(4, 0, 1, 1, 0), 0, 100),
+        c_warr(std::make_shared<c_tid>(4, -2, 2, 1, 0), -200, 100),
+        c_warr(std::make_shared<c_tid>(3, 5, 3, 1, 0), -50, 100),
+        c_warr(std::make_shared<c_tid>(4, -2, 2, 4, -4), -300, -100),
+        c_warr(std::make_shared<c_tid>(5, 0, 1, 3, 2), 0, 500),
+    };
+    for (const auto &warr : warr_list) {
+        cbag::layout::add_warr(cv_ref, warr);
+    }
+    cv.add_warrs(warr_list, hint);
+
+    REQUIRE(cv == cv_ref);
+    REQUIRE(!cv.is_bulk_mode());
+    REQUIRE(cv.get_track_occupancy() == cv_ref.get_track_occupancy());
+    for (auto lev = grid.get_bot_level(); lev <= grid.get_top_level(); ++lev) {
+        REQUIRE(cv.get_geo_index(lev).size() == cv_ref.get_geo_index(lev).size());
+    }
+    auto key = layer_t_at(tech_info, "M4", "drawing");
+    REQUIRE(cv.get_bbox(key) == cv_ref.get_bbox(key));
+}
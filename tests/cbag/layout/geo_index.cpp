@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/common/box_t_util.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/layout/cellview.h>
+#include <cbag/layout/cellview_poly.h>
+#include <cbag/layout/cellview_util.h>
+#include <cbag/layout/cv_obj_ref.h>
+#include <cbag/layout/geo_iterator.h>
+#include <cbag/layout/grid_object.h>
+#include <cbag/layout/routing_grid.h>
+
+using c_tech = cbag::layout::tech;
+using c_grid = cbag::layout::routing_grid;
+using c_cellview = cbag::layout::cellview;
+using c_tid = cbag::layout::track_id;
+using c_warr = cbag::layout::wire_array;
+using c_box = cbag::box_t;
+
+namespace {
+
+c_tech make_tech() { return c_tech("tests/data/test_layout/tech_params.yaml"); }
+c_grid make_grid(const c_tech &tech) { return c_grid(&tech, "tests/data/test_layout/grid.yaml"); }
+
+void draw_wires(c_cellview &cv) {
+    for (cbag::htr_t htr = -20; htr < 20; ++htr) {
+        cbag::layout::add_warr(cv, c_warr(std::make_shared<c_tid>(4, htr, 1, 1, 0), -1000, 1000));
+        cbag::layout::add_warr(cv, c_warr(std::make_shared<c_tid>(5, htr, 1, 1, 0), -1000, 1000));
+    }
+}
+
+std::size_t count_intersect(const c_cellview &cv, cbag::level_t lev, const c_box &box) {
+    std::size_t ans = 0;
+    for (auto iter = cv.get_geo_index(lev).begin_intersect(box, 0, 0, cbag::make_xform());
+         iter.has_next(); ++iter) {
+        ++ans;
+    }
+    return ans;
+}
+
+std::size_t count_visit(const c_cellview &cv, cbag::level_t lev, const c_box &box) {
+    std::size_t ans = 0;
+    cv.get_geo_index(lev).visit_intersect(box, 0, 0, cbag::make_xform(),
+                                          [&ans](const cbag::layout::geo_view &v) {
+                                              ++ans;
+                                              return false;
+                                          });
+    return ans;
+}
+
+} // namespace
+
+TEST_CASE("bulk mode geo_index matches incremental insertion", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto cv_ref = c_cellview(&grid, "CBAG_REF");
+    auto cv_bulk = c_cellview(&grid, "CBAG_BULK");
+    auto box = GENERATE(values<c_box>({
+        c_box(0, 0, 0, 0),
+        c_box(-100, -100, 100, 100),
+        c_box(-2000, -2000, 2000, 2000),
+        c_box(5000, 5000, 6000, 6000),
+    }));
+
+    draw_wires(cv_ref);
+    {
+        cbag::layout::build_session session(cv_bulk);
+        draw_wires(cv_bulk);
+        REQUIRE(cv_bulk.is_bulk_mode());
+    }
+    REQUIRE_FALSE(cv_bulk.is_bulk_mode());
+
+    for (auto lev : {4, 5}) {
+        REQUIRE(cv_bulk.get_geo_index(lev).size() == cv_ref.get_geo_index(lev).size());
+        REQUIRE(cv_bulk.get_geo_index(lev).get_bbox() == cv_ref.get_geo_index(lev).get_bbox());
+        REQUIRE(count_intersect(cv_bulk, lev, box) == count_intersect(cv_ref, lev, box));
+    }
+}
+
+TEST_CASE("bulk mode geo_index builds on first query", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto cv = c_cellview(&grid, "CBAG_BULK");
+
+    cv.set_bulk_mode(true);
+    cbag::layout::add_warr(cv, c_warr(std::make_shared<c_tid>(4, 0, 1, 1, 0), 0, 100));
+    REQUIRE(count_intersect(cv, 4, c_box(0, -1000, 100, 1000)) == 1);
+    cbag::layout::add_warr(cv, c_warr(std::make_shared<c_tid>(4, 2, 1, 1, 0), 0, 100));
+    REQUIRE(count_intersect(cv, 4, c_box(0, -1000, 100, 1000)) == 2);
+    cv.set_bulk_mode(false);
+    REQUIRE(cv.get_geo_index(4).size() == 2);
+}
+
+TEST_CASE("concurrent first queries build the bulk mode geo_index once", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto cv = c_cellview(&grid, "CBAG_BULK");
+    auto box = c_box(-2000, -2000, 2000, 2000);
+
+    cv.set_bulk_mode(true);
+    draw_wires(cv);
+    std::vector<std::size_t> count_list(4, 0);
+    std::vector<std::thread> thread_list;
+    for (std::size_t idx = 0; idx < count_list.size(); ++idx) {
+        thread_list.emplace_back(
+            [&cv, &box, &count_list, idx]() { count_list[idx] = count_intersect(cv, 4, box); });
+    }
+    for (auto &t : thread_list) {
+        t.join();
+    }
+    for (auto count : count_list) {
+        REQUIRE(count == 40);
+    }
+    REQUIRE(cv.get_geo_index(4).size() == 40);
+}
+
+TEST_CASE("hierarchical query composes instance transformations", "[layout::geo_index]") {
+    using data_type = std::tuple<cbag::transformation, cbag::transformation>;
+
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto [xform1, xform2] = GENERATE(values<data_type>({
+        {cbag::make_xform(0, 0), cbag::make_xform(0, 0)},
+        {cbag::make_xform(1000, 0, cbag::oR90), cbag::make_xform(0, 500, cbag::oMX)},
+        {cbag::make_xform(-300, 200, cbag::oMXR90), cbag::make_xform(40, -70, cbag::oR270)},
+    }));
+
+    auto key = cbag::layout::layer_t_at(tech, "M4", "");
+    auto box = c_box(0, 0, 100, 20);
+    auto master = c_cellview(&grid, "CBAG_LEAF");
+    master.add_shape(key, box);
+    auto mid = c_cellview(&grid, "CBAG_MID");
+    cbag::layout::add_instance(mid, &master, "X0", xform1, 1, 1, 0, 0, true);
+    auto top = c_cellview(&grid, "CBAG_TOP");
+    cbag::layout::add_instance(top, &mid, "X0", xform2, 1, 1, 0, 0, true);
+
+    auto expect = cbag::get_transform(cbag::get_transform(box, xform1), xform2);
+    auto &index = top.get_geo_index(4);
+    auto iter = index.begin_intersect(c_box(-5000, -5000, 5000, 5000), 0, 0, cbag::make_xform());
+    REQUIRE(iter.has_next());
+    REQUIRE(std::get<c_box>((*iter).val) == expect);
+    ++iter;
+    REQUIRE_FALSE(iter.has_next());
+
+    auto miss = index.begin_intersect(cbag::get_move_by(expect, 0, 10000), 0, 0,
+                                      cbag::make_xform());
+    REQUIRE_FALSE(miss.has_next());
+}
+
+TEST_CASE("hierarchical query handles hierarchies deeper than the inline stack",
+          "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto key = cbag::layout::layer_t_at(tech, "M4", "");
+    auto box = c_box(0, 0, 100, 20);
+    auto num_levels = cbag::layout::geo_traversal::inline_depth + 8;
+
+    // every cell has one shape and an instance of the previous cell, shifted by 10.
+    std::deque<c_cellview> cv_list;
+    for (std::size_t idx = 0; idx <= num_levels; ++idx) {
+        auto &cv = cv_list.emplace_back(&grid, "CBAG_L" + std::to_string(idx));
+        cv.add_shape(key, box);
+        if (idx > 0)
+            cbag::layout::add_instance(cv, &cv_list[idx - 1], "X0", cbag::make_xform(10, 0), 1, 1,
+                                       0, 0, true);
+    }
+
+    auto &top = cv_list.back();
+    auto query = c_box(-5000, -5000, 5000, 5000);
+    std::vector<cbag::offset_t> xl_list;
+    for (auto iter = top.get_geo_index(4).begin_intersect(query, 0, 0, cbag::make_xform());
+         iter.has_next(); ++iter) {
+        xl_list.push_back(cbag::xl(std::get<c_box>((*iter).val)));
+    }
+    REQUIRE(xl_list.size() == num_levels + 1);
+    std::sort(xl_list.begin(), xl_list.end());
+    for (std::size_t idx = 0; idx <= num_levels; ++idx) {
+        REQUIRE(xl_list[idx] == static_cast<cbag::offset_t>(10 * idx));
+    }
+    REQUIRE(count_visit(top, 4, query) == num_levels + 1);
+}
+
+TEST_CASE("visit_intersect matches geo_iterator", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    auto box = GENERATE(values<c_box>({
+        c_box(0, 0, 0, 0),
+        c_box(-100, -100, 100, 100),
+        c_box(-2000, -2000, 2000, 2000),
+        c_box(5000, 5000, 6000, 6000),
+    }));
+
+    draw_wires(cv);
+    for (auto lev : {4, 5}) {
+        REQUIRE(count_visit(cv, lev, box) == count_intersect(cv, lev, box));
+    }
+
+    std::size_t num_visit = 0;
+    auto stopped = cv.get_geo_index(4).visit_intersect(
+        box, 0, 0, cbag::make_xform(), [&num_visit](const cbag::layout::geo_view &v) {
+            ++num_visit;
+            return v.kind == cbag::layout::geo_union_enum::RECT;
+        });
+    REQUIRE(stopped == (count_intersect(cv, 4, box) > 0));
+    REQUIRE(num_visit == (stopped ? 1 : 0));
+}
+
+TEST_CASE("visit_intersect reports hierarchical transformation", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto xform1 = cbag::make_xform(-300, 200, cbag::oMXR90);
+    auto xform2 = cbag::make_xform(40, -70, cbag::oR270);
+
+    auto key = cbag::layout::layer_t_at(tech, "M4", "");
+    auto box = c_box(0, 0, 100, 20);
+    auto master = c_cellview(&grid, "CBAG_LEAF");
+    master.add_shape(key, box);
+    auto top = c_cellview(&grid, "CBAG_TOP");
+    cbag::layout::add_instance(top, &master, "X0", xform1, 1, 1, 0, 0, true);
+
+    std::vector<c_box> ans;
+    top.get_geo_index(4).visit_intersect(c_box(-5000, -5000, 5000, 5000), 0, 0, xform2,
+                                         [&ans](const cbag::layout::geo_view &v) {
+                                             ans.push_back(cbag::get_transform(v.bbox, v.xform));
+                                             return false;
+                                         });
+    REQUIRE(ans.size() == 1);
+    REQUIRE(ans[0] == cbag::get_transform(cbag::get_transform(box, xform1), xform2));
+}
+
+TEST_CASE("instance arrays occupy a single index entry", "[layout::geo_index]") {
+    using data_type = std::tuple<cbag::transformation, cbag::offset_t, cbag::offset_t>;
+
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto [xform, spx, spy] = GENERATE(values<data_type>({
+        {cbag::make_xform(0, 0), 500, 300},
+        {cbag::make_xform(1000, 0, cbag::oR90), -500, 300},
+        {cbag::make_xform(-300, 200, cbag::oMX), 200, -100},
+    }));
+    auto query = GENERATE(values<c_box>({
+        c_box(-5000, -5000, 5000, 5000),
+        c_box(0, 0, 0, 0),
+        c_box(450, 250, 550, 350),
+        c_box(-700, -50, 1100, 20),
+    }));
+    cbag::cnt_t nx = 4;
+    cbag::cnt_t ny = 3;
+
+    auto key = cbag::layout::layer_t_at(tech, "M4", "");
+    auto master = c_cellview(&grid, "CBAG_LEAF");
+    master.add_shape(key, c_box(0, 0, 100, 20));
+    auto top = c_cellview(&grid, "CBAG_TOP");
+    cbag::layout::add_instance(top, &master, "X0", xform, nx, ny, spx, spy, true);
+    auto ref = c_cellview(&grid, "CBAG_REF");
+    for (cbag::cnt_t ix = 0; ix < nx; ++ix) {
+        for (cbag::cnt_t iy = 0; iy < ny; ++iy) {
+            cbag::layout::add_instance(ref, &master, "",
+                                       cbag::get_move_by(xform, ix * spx, iy * spy), 1, 1, 0, 0,
+                                       true);
+        }
+    }
+
+    REQUIRE(top.get_geo_index(4).size() == 1);
+    REQUIRE(ref.get_geo_index(4).size() == nx * ny);
+    REQUIRE(top.get_geo_index(4).get_bbox() == ref.get_geo_index(4).get_bbox());
+    REQUIRE(count_intersect(top, 4, query) == count_intersect(ref, 4, query));
+    REQUIRE(count_visit(top, 4, query) == count_intersect(ref, 4, query));
+}
+
+TEST_CASE("rectangle arrays are indexed as a single entry", "[layout::geo_index]") {
+    auto tech = make_tech();
+    auto grid = make_grid(tech);
+    auto cv_ref = c_cellview(&grid, "CBAG_REF");
+    auto cv_arr = c_cellview(&grid, "CBAG_ARR");
+    auto key = cbag::layout::layer_t_at(tech, "M4", "");
+    auto base = c_box(0, 0, 40, 40);
+    using data_type = std::tuple<cbag::cnt_t, cbag::cnt_t, cbag::offset_t, cbag::offset_t>;
+    auto [nx, ny, spx, spy] = GENERATE(values<data_type>({
+        {1, 1, 0, 0},
+        {10, 1, 100, 0},
+        {4, 6, 100, -80},
+        {5, 5, 30, 30},
+    }));
+    auto box = GENERATE(values<c_box>({
+        c_box(0, 0, 0, 0),
+        c_box(130, -300, 250, 50),
+        c_box(-2000, -2000, 2000, 2000),
+    }));
+
+    for (cbag::cnt_t ix = 0; ix < nx; ++ix) {
+        for (cbag::cnt_t iy = 0; iy < ny; ++iy) {
+            cv_ref.add_shape(key, cbag::get_move_by(base, ix * spx, iy * spy));
+        }
+    }
+    cbag::layout::add_rect_arr(cv_arr, key, base, {nx, ny}, {spx, spy});
+
+    REQUIRE(cv_arr.get_geo_index(4).size() == 1);
+    REQUIRE(cv_arr.get_bbox(key) == cv_ref.get_bbox(key));
+    REQUIRE(cv_arr.find_geometry(key)->second == cv_ref.find_geometry(key)->second);
+    REQUIRE(count_intersect(cv_arr, 4, box) == count_intersect(cv_ref, 4, box));
+    REQUIRE(count_visit(cv_arr, 4, box) == count_visit(cv_ref, 4, box));
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include <cbag/common/box_t_util.h>
+#include <cbag/layout/geometry.h>
+
+using c_box = cbag::box_t;
+using c_geometry = cbag::layout::geometry;
+using c_point = boost::polygon::point_data<cbag::coord_t>;
+
+TEST_CASE("geometry rectangle storage", "[layout::geometry]") {
+    auto mode = GENERATE(cbag::geometry_mode::POLY90, cbag::geometry_mode::POLY45,
+                         cbag::geometry_mode::POLY);
+
+    c_geometry geo(mode);
+    REQUIRE(geo.is_rect_only());
+    REQUIRE(!cbag::is_valid(geo.get_bbox()));
+
+    geo.add_shape(c_box(0, 0, 100, 20));
+    geo.add_shape(c_box(80, 0, 200, 20));
+    geo.add_shape(c_box(-50, 50, -50, 70));
+    REQUIRE(geo.is_rect_only());
+    REQUIRE(geo.get_bbox() == c_box(0, 0, 200, 20));
+
+    // rectangles are merged on output
+    std::vector<cbag::layout::polygon> poly_list;
+    geo.write_geometry(poly_list);
+    REQUIRE(poly_list.size() == 1);
+
+    // compares equal to the same region stored as a polygon set
+    std::vector<c_point> pts{{0, 0}, {200, 0}, {200, 20}, {150, 20}, {150, 10}, {0, 10}};
+    cbag::layout::polygon90 poly;
+    poly.set(pts.begin(), pts.end());
+    c_geometry expect(mode);
+    expect.add_shape(poly);
+    REQUIRE(!expect.is_rect_only());
+    expect.add_shape(c_box(0, 10, 150, 20));
+    REQUIRE(expect == geo);
+    REQUIRE(expect.get_bbox() == geo.get_bbox());
+}
+
+TEST_CASE("geometry conversion to polygon set", "[layout::geometry]") {
+    std::vector<c_point> pts{{0, 0}, {100, 0}, {0, 100}};
+    cbag::layout::polygon45 poly;
+    poly.set(pts.begin(), pts.end());
+
+    c_geometry geo90(cbag::geometry_mode::POLY90);
+    geo90.add_shape(c_box(0, 0, 10, 10));
+    REQUIRE_THROWS_AS(geo90.add_shape(poly), std::invalid_argument);
+
+    c_geometry geo45(cbag::geometry_mode::POLY45);
+    geo45.add_shape(c_box(0, 0, 200, 10));
+    geo45.add_shape(poly);
+    REQUIRE(!geo45.is_rect_only());
+    REQUIRE(geo45.get_bbox() == c_box(0, 0, 200, 100));
+}
+
+TEST_CASE("geometry merge cache", "[layout::geometry]") {
+    auto mode = GENERATE(cbag::geometry_mode::POLY90, cbag::geometry_mode::POLY45);
+
+    c_geometry geo(mode);
+    geo.add_shape(c_box(0, 0, 100, 20));
+    geo.add_shape(c_box(0, 100, 100, 120));
+
+    std::vector<cbag::layout::polygon> first;
+    std::vector<cbag::layout::polygon> second;
+    geo.write_geometry(first);
+    geo.write_geometry(second);
+    REQUIRE(first.size() == 2);
+    REQUIRE(first == second);
+
+    // adding a shape invalidates the merged result
+    geo.add_shape(c_box(0, 0, 20, 120));
+    std::vector<cbag::layout::polygon> third;
+    geo.write_geometry(third);
+    REQUIRE(third.size() == 1);
+    REQUIRE(geo.get_bbox() == c_box(0, 0, 100, 120));
+}
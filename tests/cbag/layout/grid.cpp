@@ -1,7 +1,13 @@
 #include <catch2/catch.hpp>
 
+#include <cbag/common/box_t_util.h>
+#include <cbag/common/transformation_util.h>
+#include <cbag/enum/space_type.h>
+#include <cbag/layout/flip_parity.h>
+#include <cbag/layout/flip_parity_cache.h>
 #include <cbag/layout/routing_grid_util.h>
 #include <cbag/layout/tech.h>
+#include <cbag/layout/tech_util.h>
 
 using c_tech = cbag::layout::tech;
 using c_grid = cbag::layout::routing_grid;
@@ -41,3 +47,60 @@ TEST_CASE("get_top_track_pitches()", "[grid]") {
     REQUIRE(x_pitch == x_pitch_expect);
     REQUIRE(y_pitch == y_pitch_expect);
 }
+
+TEST_CASE("get_margins() depends on layer and width", "[grid]") {
+    c_tech tech_info("tests/data/test_layout/tech_params.yaml");
+    c_grid grid(&tech_info, "tests/data/test_layout/grid.yaml");
+
+    auto lev = GENERATE(range(1, 7));
+    auto key = cbag::layout::get_test_lay_purp(tech_info, lev);
+    auto dir = grid[lev].get_direction();
+    auto pdir = cbag::perpendicular(dir);
+
+    for (c_offset_t w : {40, 100, 800}) {
+        cbag::box_t box;
+        set_interval(box, pdir, 0, w);
+        set_interval(box, dir, 0, 1000);
+        std::array<c_offset_t, 2> expect;
+        expect[cbag::to_int(dir)] =
+            tech_info.get_min_space(key, w, cbag::space_type::LINE_END, false);
+        expect[cbag::to_int(pdir)] =
+            tech_info.get_min_space(key, w, cbag::space_type::DIFF_COLOR, false);
+
+        // margins do not depend on the shape location
+        for (c_offset_t shift = 0; shift < 3; ++shift) {
+            move_by(box, 10 * shift, 20 * shift);
+            REQUIRE(get_margins(grid, key, lev, box) == expect);
+        }
+    }
+}
+
+TEST_CASE("get_flip_parity_at() shares results of equivalent placements", "[grid]") {
+    c_tech tech_info("tests/data/test_layout/tech_params.yaml");
+    c_grid grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto &cache = grid.get_flip_parity_cache();
+
+    // every level has one color, so the coloring period is the track pitch along each axis
+    auto fp = grid.get_flip_parity_at(1, 4, cbag::make_xform(0, 0));
+    REQUIRE(fp == grid.get_flip_parity_at(1, 4, cbag::make_xform(120, -240)));
+    REQUIRE(fp != grid.get_flip_parity_at(1, 4, cbag::make_xform(60, 0)));
+    REQUIRE(fp != grid.get_flip_parity_at(1, 4, cbag::make_xform(0, 0, cbag::oMX)));
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.get_num_hits() == 1);
+    REQUIRE(grid.get_flip_parity_at(1, 4, cbag::make_xform(60, 0)) ==
+            grid.get_flip_parity_at(1, 4, cbag::make_xform(-60, 120)));
+    REQUIRE(*grid.get_flip_parity_at(5, 8, cbag::make_xform(180, 90)) ==
+            *grid.get_flip_parity_at(5, 8, cbag::make_xform(180 + 720, 90 - 360)));
+    REQUIRE_THROWS_AS(grid.get_flip_parity_at(1, 4, cbag::make_xform(1, 0)),
+                      std::invalid_argument);
+
+    // parities computed from a cached flip parity match the direct computation
+    auto grid2 = grid;
+    grid2.set_flip_parity(*grid.get_flip_parity_at(1, 4, cbag::make_xform(60, 180, cbag::oMX)));
+    for (cbag::htr_t htr = -3; htr < 4; ++htr) {
+        REQUIRE(grid2.get_htr_parity(2, htr) == 0);
+    }
+    // modifying a grid does not affect the cache of its copies
+    REQUIRE(&grid2.get_flip_parity_cache() != &cache);
+    REQUIRE(cache.size() == 5);
+}
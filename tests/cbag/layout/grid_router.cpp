@@ -0,0 +1,169 @@
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/layout/cellview.h>
+#include <cbag/layout/grid_router.h>
+#include <cbag/layout/routing_grid.h>
+#include <cbag/layout/routing_grid_util.h>
+#include <cbag/layout/tech_util.h>
+
+using c_tech = cbag::layout::tech;
+using c_grid = cbag::layout::routing_grid;
+using c_cellview = cbag::layout::cellview;
+using c_box = cbag::box_t;
+using c_router = cbag::layout::grid_router;
+using c_point = cbag::layout::route_point;
+using c_wire = cbag::layout::route_wire;
+
+// horizontal tracks of level 4 are at y = 60 + 120 * (htr / 2).  Stops along them are the
+// vertical tracks of level 3 at x = 60 + 120 * k and, if level 5 is routed, of level 5 at
+// x = 90 + 180 * k.
+TEST_CASE("route straight wire", "[layout::grid_router]") {
+    auto tech_info = c_tech("tests/data/test_layout/tech_params.yaml");
+    auto grid = c_grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    auto router = c_router(cv, 3, 4, c_box(0, 0, 1000, 1000), 200);
+
+    REQUIRE(router.is_node({4, 0, 60}));
+    REQUIRE(!router.is_node({4, 0, 90}));
+    REQUIRE(c_router(cv, 3, 5, c_box(0, 0, 1000, 1000), 200).is_node({4, 0, 90}));
+    REQUIRE(!router.is_node({4, 1, 60}));
+    REQUIRE(!router.is_node({4, 0, 61}));
+    REQUIRE(!router.is_node({5, 0, 60}));
+
+    auto ans = router.route({4, 0, 60}, {4, 0, 900});
+    REQUIRE(ans.success);
+    REQUIRE(ans.cost == 840);
+    REQUIRE(ans.wires == std::vector<c_wire>{{4, 0, {60, 900}}});
+    REQUIRE(ans.vias.empty());
+
+    REQUIRE_THROWS_AS(router.route({4, 1, 60}, {4, 0, 900}), std::invalid_argument);
+    REQUIRE_THROWS_AS(c_router(cv, 4, 3, c_box(0, 0, 1000, 1000), 200), std::out_of_range);
+    REQUIRE_THROWS_AS(c_router(cv, 3, 4, c_box(0, 0, 1000, 1000), -1), std::invalid_argument);
+}
+
+TEST_CASE("route around obstacles", "[layout::grid_router]") {
+    auto tech_info = c_tech("tests/data/test_layout/tech_params.yaml");
+    auto grid = c_grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    cv.add_shape(layer_t_at(tech_info, "M4", "drawing"), c_box(400, 30, 500, 90));
+    auto router = c_router(cv, 3, 4, c_box(0, 0, 1000, 1000), 200);
+
+    auto ans = router.route({4, 0, 60}, {4, 0, 900});
+    REQUIRE(ans.success);
+    // level 3 is vertical, so the detour jumps to the next track and back with four vias
+    REQUIRE(ans.cost == 840 + 2 * 120 + 4 * 200);
+    REQUIRE(ans.vias.size() == 4);
+    for (const auto &v : ans.vias) {
+        REQUIRE(v.level == 3);
+    }
+
+    // routing is deterministic
+    auto ans2 = router.route({4, 0, 60}, {4, 0, 900});
+    REQUIRE(ans2.cost == ans.cost);
+    REQUIRE(ans2.wires == ans.wires);
+    REQUIRE(ans2.vias == ans.vias);
+
+    // drawn routes block later routes
+    cbag::layout::add_route(cv, ans);
+    auto ans3 = router.route({4, 0, 60}, {4, 0, 900});
+    REQUIRE(!ans3.success);
+    REQUIRE(ans3.wires.empty());
+}
+
+TEST_CASE("route onto shapes of the same net", "[layout::grid_router]") {
+    auto tech_info = c_tech("tests/data/test_layout/tech_params.yaml");
+    auto grid = c_grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    auto pin_box = c_box(400, 30, 500, 90);
+    cv.add_shape(layer_t_at(tech_info, "M4", "drawing"), pin_box);
+    auto router = c_router(cv, 3, 4, c_box(0, 0, 1000, 1000), 200);
+
+    // a terminal inside a shape of another net cannot be reached
+    REQUIRE(!router.route({4, 0, 900}, {4, 0, 420}).success);
+
+    auto ans = router.route({4, 0, 900}, {4, 0, 420}, {{4, pin_box}});
+    REQUIRE(ans.success);
+    REQUIRE(ans.cost == 480);
+    REQUIRE(ans.wires == std::vector<c_wire>{{4, 0, {420, 900}}});
+
+    // extend an existing wire
+    cbag::layout::add_route(cv, router.route({4, 4, 60}, {4, 4, 300}));
+    auto bnds = cbag::layout::get_wire_bounds(grid, 4, 4, 1);
+    auto half_w = (bnds[1] - bnds[0]) / 2;
+    auto wire_box = c_box(60 - half_w, bnds[0], 300 + half_w, bnds[1]);
+    REQUIRE(!router.route({4, 4, 300}, {4, 4, 900}).success);
+
+    auto ans2 = router.route({4, 4, 300}, {4, 4, 900}, {{4, wire_box}});
+    REQUIRE(ans2.success);
+    REQUIRE(ans2.cost == 600);
+    REQUIRE(ans2.wires == std::vector<c_wire>{{4, 4, {300, 900}}});
+
+    // net boxes only apply to the call they are passed to
+    REQUIRE(!router.route({4, 4, 300}, {4, 4, 900}).success);
+}
+
+TEST_CASE("route multiple terminals", "[layout::grid_router]") {
+    auto tech_info = c_tech("tests/data/test_layout/tech_params.yaml");
+    auto grid = c_grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    auto router = c_router(cv, 3, 4, c_box(0, 0, 1000, 1000), 200);
+
+    auto terms = std::vector<c_point>{{4, 0, 60}, {4, 0, 900}, {4, 8, 540}, {4, 0, 60}};
+    auto ans = router.route(terms);
+    REQUIRE(ans.success);
+    // the trunk along htr 0 plus a branch down a level 3 track
+    REQUIRE(ans.cost == 840 + 480 + 2 * 200);
+    REQUIRE(ans.vias.size() == 2);
+
+    auto single = router.route(std::vector<c_point>{{4, 0, 60}});
+    REQUIRE(single.success);
+    REQUIRE(single.cost == 0);
+}
+
+TEST_CASE("route congested grid", "[.][benchmark][layout::grid_router]") {
+    auto tech_info = c_tech("tests/data/test_layout/tech_params.yaml");
+    auto grid = c_grid(&tech_info, "tests/data/test_layout/grid.yaml");
+    auto cv = c_cellview(&grid, "CBAG_TEST");
+    auto num_obs = GENERATE(values<int>({200, 800}));
+
+    // random blockages on the two middle levels
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> pos_dist(0, 50);
+    std::uniform_int_distribution<int> len_dist(1, 8);
+    std::uniform_int_distribution<int> lay_dist(0, 1);
+    auto m2 = layer_t_at(tech_info, "M2", "drawing");
+    auto m3 = layer_t_at(tech_info, "M3", "drawing");
+    for (int idx = 0; idx < num_obs; ++idx) {
+        auto x = 120 * pos_dist(gen);
+        auto y = 120 * pos_dist(gen);
+        auto len = 120 * len_dist(gen);
+        if (lay_dist(gen) == 0)
+            cv.add_shape(m2, c_box(x, y + 30, x + len, y + 90));
+        else
+            cv.add_shape(m3, c_box(x + 30, y, x + 90, y + len));
+    }
+
+    auto router = c_router(cv, 1, 4, c_box(0, 0, 6000, 6000), 240);
+    std::uniform_int_distribution<int> tr_dist(0, 45);
+    int num_success = 0;
+    int num_nets = 50;
+    auto start = std::chrono::steady_clock::now();
+    for (int idx = 0; idx < num_nets; ++idx) {
+        auto src = c_point{4, 2 * tr_dist(gen), 60 + 120 * tr_dist(gen)};
+        auto dst = c_point{4, 2 * tr_dist(gen), 60 + 120 * tr_dist(gen)};
+        auto ans = router.route(src, dst);
+        if (ans.success) {
+            ++num_success;
+            cbag::layout::add_route(cv, ans);
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+    WARN(num_obs << " obstacles, " << router.get_num_nodes() << " nodes: routed " << num_success
+                 << "/" << num_nets << " nets in " << msec << " ms");
+}
@@ -25,6 +25,25 @@ TEST_CASE("technology layer/purpose lookup", "[tech]") {
     REQUIRE(purp_id == cbag::layout::purpose_id_at(obj, purp_name));
     REQUIRE(obj.get_purpose_id("drawing") == cbag::layout::purpose_id_at(obj, ""));
     REQUIRE(cbag::layer_t(lay_id, purp_id) == cbag::layout::layer_t_at(obj, lay_name, purp_name));
+    REQUIRE(obj.get_layer_name(lay_id) == lay_name);
+    REQUIRE(obj.get_purpose_name(purp_id) == purp_name);
+
+    auto names = obj.get_lay_purp_names({{lay_id, purp_id}, {lay_id, 12345}, {54321, purp_id}});
+    REQUIRE(names.size() == 3);
+    REQUIRE(*names[0].first == lay_name);
+    REQUIRE(*names[0].second == purp_name);
+    REQUIRE(*names[1].first == lay_name);
+    REQUIRE(names[1].second == nullptr);
+    REQUIRE(names[2].first == nullptr);
+    REQUIRE(*names[2].second == purp_name);
+}
+
+TEST_CASE("technology name lookup of undefined IDs throws", "[tech]") {
+    c_tech obj("tests/data/test_layout/tech_params.yaml");
+
+    REQUIRE_THROWS_AS(obj.get_layer_name(54321), std::out_of_range);
+    REQUIRE_THROWS_AS(obj.get_purpose_name(12345), std::out_of_range);
+    REQUIRE_THROWS_AS(obj.get_purpose_name(4294967000), std::out_of_range);
 }
 
 TEST_CASE("technology get_min_space", "[tech]") {
@@ -66,3 +85,66 @@ TEST_CASE("technology get_min_length", "[tech]") {
     auto key = layer_t_at(obj, lay_name, "drawing");
     REQUIRE(obj.get_min_length(key, w, even) == min_len);
 }
+
+TEST_CASE("technology level-based min space/length", "[tech]") {
+    c_tech obj("tests/data/test_layout/tech_params.yaml");
+
+    auto level = GENERATE(range(1, 7));
+    auto w = GENERATE(values<cbag::offset_t>({1, 20, 59, 60, 99, 100, 9999}));
+    auto even = GENERATE(true, false);
+    auto sp_type = GENERATE(cbag::space_type::DIFF_COLOR, cbag::space_type::SAME_COLOR,
+                            cbag::space_type::LINE_END);
+
+    auto key = cbag::layout::get_test_lay_purp(obj, level);
+    REQUIRE(obj.get_min_space(level, w, sp_type, even) ==
+            obj.get_min_space(key, w, sp_type, even));
+    REQUIRE(obj.get_min_length(level, w, even) == obj.get_min_length(key, w, even));
+    REQUIRE_THROWS_AS(obj.get_min_space(cbag::level_t{100}, w, sp_type, even), std::out_of_range);
+}
+
+TEST_CASE("compiled rule table matches first-match rules", "[tech]") {
+    using w_sp_list_t = std::vector<std::pair<cbag::offset_t, cbag::offset_t>>;
+    // breakpoints need not be sorted; the first entry that fits wins
+    auto w_sp_list = GENERATE(values<w_sp_list_t>({
+        {{10, 5}},
+        {{10, 5}, {20, 7}, {30, 9}},
+        {{10, 5}, {10, 6}, {30, 9}, {20, 7}},
+        {{30, 9}, {10, 5}, {40, 11}, {35, 3}},
+        {{20, 7}, {20, 8}, {5, 1}},
+    }));
+
+    cbag::layer_t key{60, 4294967295};
+    cbag::layout::sp_map_grp_t sp_map_grp;
+    sp_map_grp[cbag::space_type::DIFF_COLOR].emplace(key, w_sp_list);
+    cbag::layout::rule_table rules(sp_map_grp, {}, {});
+
+    auto idx = rules.get_index(key);
+    REQUIRE(idx != cbag::layout::rule_table::npos);
+    REQUIRE(rules.get_index(cbag::layer_t{60, 0}) == cbag::layout::rule_table::npos);
+    REQUIRE(rules.get_index(cbag::layer_t{59, 4294967295}) == cbag::layout::rule_table::npos);
+    REQUIRE(rules.get_index(cbag::layer_t{1000, 4294967295}) == cbag::layout::rule_table::npos);
+
+    // large layer IDs do not need a table indexed by layer
+    sp_map_grp[cbag::space_type::DIFF_COLOR].emplace(cbag::layer_t{4000000000, 0}, w_sp_list);
+    cbag::layout::rule_table sparse_rules(sp_map_grp, {}, {});
+    REQUIRE(sparse_rules.get_index(key) == idx);
+    REQUIRE(sparse_rules.get_index(cbag::layer_t{4000000000, 0}) == idx + 1);
+    REQUIRE(sparse_rules.get_index(cbag::layer_t{4000000000, 1}) ==
+            cbag::layout::rule_table::npos);
+    for (cbag::offset_t w = 0; w < 50; ++w) {
+        auto expect = w_sp_list.back().second;
+        for (const auto &[w_spec, sp] : w_sp_list) {
+            if (w <= w_spec) {
+                expect = sp;
+                break;
+            }
+        }
+        REQUIRE(rules.get_min_space(idx, w, cbag::space_type::DIFF_COLOR, false) == expect);
+        // same color rules fall back to different color rules
+        REQUIRE(rules.get_min_space(idx, w, cbag::space_type::SAME_COLOR, false) == expect);
+        // undefined space types are errors, not zero spacing
+        REQUIRE_THROWS_AS(rules.get_min_space(idx, w, cbag::space_type::LINE_END, false),
+                          std::out_of_range);
+        REQUIRE(rules.get_min_length(idx, w, false) == 0);
+    }
+}
@@ -1,12 +1,16 @@
 #include <catch2/catch.hpp>
 
+#include <yaml-cpp/yaml.h>
+
 #include <cbag/common/transformation_util.h>
 #include <cbag/common/vector.h>
 #include <cbag/enum/direction.h>
 #include <cbag/enum/orient_2d.h>
 #include <cbag/layout/tech_util.h>
+#include <cbag/layout/via.h>
 #include <cbag/layout/via_param.h>
 #include <cbag/layout/via_util.h>
+#include <cbag/yaml/via_info.h>
 
 using c_tech = cbag::layout::tech;
 using c_vector = cbag::vector;
@@ -61,3 +65,83 @@ TEST_CASE("get via cuts", "[via]") {
     cbag::layout::get_via_cuts(via, std::back_inserter(ans));
     REQUIRE(ans == expect);
 }
+
+TEST_CASE("get_via_param() results are cached", "[via]") {
+    c_tech obj("tests/data/test_layout/tech_params.yaml");
+    auto bot_dir = cbag::orient_2d::HORIZONTAL;
+    auto top_dir = cbag::orient_2d::VERTICAL;
+    auto via_id = obj.get_via_id(cbag::direction::LOWER, layer_t_at(obj, "M1", "drawing"),
+                                 layer_t_at(obj, "M2", "drawing"));
+    auto &cache = obj.get_via_param_cache();
+
+    auto p1 = obj.get_via_param({84, 32}, via_id, cbag::direction::LOWER, bot_dir, top_dir, true);
+    REQUIRE(cache.get_num_misses() == 1);
+    REQUIRE(cache.get_num_hits() == 0);
+    auto p2 = obj.get_via_param({84, 32}, via_id, cbag::direction::LOWER, bot_dir, top_dir, true);
+    REQUIRE(cache.get_num_hits() == 1);
+    REQUIRE(p1 == p2);
+
+    // different arguments are different cache entries
+    auto p3 = obj.get_via_param({32, 84}, via_id, cbag::direction::LOWER, bot_dir, top_dir, true);
+    REQUIRE(cache.get_num_misses() == 2);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(p3 == c_via_param(1, 1, 32, 64, 0, 0, 10, 10, 10, 10, 0, 0, 20, 20));
+}
+
+TEST_CASE("get_via_param() uses precomputed via tables", "[via]") {
+    c_tech obj("tests/data/test_layout/tech_params.yaml");
+    auto via_id = obj.get_via_id(cbag::direction::LOWER, layer_t_at(obj, "M1", "drawing"),
+                                 layer_t_at(obj, "M2", "drawing"));
+    auto vinfo_list = YAML::LoadFile("tests/data/test_layout/tech_params.yaml")["via"][via_id]
+                          .as<std::vector<cbag::layout::via_info>>();
+    auto &cache = obj.get_via_param_cache();
+    auto vdir = GENERATE(cbag::direction::LOWER, cbag::direction::UPPER);
+    auto ex_dir = GENERATE(cbag::orient_2d::HORIZONTAL, cbag::orient_2d::VERTICAL);
+    auto extend = GENERATE(false, true);
+    auto dim = GENERATE(values<c_vector>({{31, 32}, {32, 32}, {34, 36}, {36, 31}}));
+    auto adj_ex_dir = cbag::perpendicular(ex_dir);
+
+    // table entries match the search result and bypass the cache
+    auto expect =
+        cbag::layout::compute_via_param(vinfo_list, dim, vdir, ex_dir, adj_ex_dir, extend);
+    auto ans = obj.get_via_param(dim, via_id, vdir, ex_dir, adj_ex_dir, extend);
+    REQUIRE(ans == expect);
+    REQUIRE(cache.get_num_misses() == 0);
+}
+
+TEST_CASE("via definitions are interned", "[via]") {
+    c_tech obj("tests/data/test_layout/tech_params.yaml");
+    auto l1 = layer_t_at(obj, "M1", "drawing");
+    auto l2 = layer_t_at(obj, "M2", "drawing");
+
+    auto vdef = obj.get_via_def(cbag::direction::LOWER, l1, l2);
+    auto &via_id = obj.get_via_id(cbag::direction::LOWER, l1, l2);
+    REQUIRE(cbag::layout::get_via_id_str(vdef) == via_id);
+    REQUIRE(cbag::layout::intern_via_id(via_id) == vdef);
+    REQUIRE(cbag::layout::find_via_def(via_id) == vdef);
+    REQUIRE(!cbag::layout::find_via_def("__never_interned__"));
+    REQUIRE(obj.get_via_layer_purpose(vdef) == obj.get_via_layer_purpose(via_id));
+    REQUIRE_THROWS_AS(obj.get_via_layer_purpose("__never_interned__"), std::out_of_range);
+
+    auto param = c_via_param(1, 1, 32, 32, 0, 0, 40, 40, 0, 0, 0, 0, 40, 40);
+    auto v1 = cbag::layout::via(cbag::make_xform(0, 0), via_id, param);
+    auto v2 = cbag::layout::via(cbag::make_xform(0, 0), vdef, param);
+    REQUIRE(v1.get_via_def() == vdef);
+    REQUIRE(v1.get_via_id() == via_id);
+    REQUIRE(v1 == v2);
+
+    auto bot_dir = cbag::orient_2d::HORIZONTAL;
+    auto top_dir = cbag::orient_2d::VERTICAL;
+    REQUIRE(obj.get_via_param({84, 32}, vdef, cbag::direction::LOWER, bot_dir, top_dir, true) ==
+            obj.get_via_param({84, 32}, via_id, cbag::direction::LOWER, bot_dir, top_dir, true));
+
+    // default-constructed vias have no via definition
+    auto v3 = cbag::layout::via();
+    REQUIRE(v3.get_via_def() == cbag::layout::invalid_via_def);
+    REQUIRE(!(v3 == cbag::layout::via(v3.xform, 0, v3.get_params())));
+    REQUIRE_THROWS_AS(v3.get_via_id(), std::out_of_range);
+    REQUIRE_THROWS_AS(obj.get_via_layer_purpose(v3.get_via_def()), std::out_of_range);
+    REQUIRE_THROWS_AS(obj.get_via_param({84, 32}, v3.get_via_def(), cbag::direction::LOWER,
+                                        bot_dir, top_dir, true),
+                      std::out_of_range);
+}
@@ -0,0 +1,59 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/util/indexed_heap.h>
+
+TEST_CASE("indexed_heap pops keys in priority order", "[indexed_heap]") {
+    auto seed = GENERATE(values<unsigned int>({0, 1, 42}));
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 20);
+
+    std::size_t n = 200;
+    cbag::util::indexed_heap<int> heap(n);
+    std::vector<int> prio(n);
+    // push every key, then change the priority of some of them
+    for (std::size_t key = 0; key < n; ++key) {
+        prio[key] = dist(gen);
+        heap.push(key, prio[key]);
+    }
+    for (std::size_t key = 0; key < n; key += 3) {
+        prio[key] = dist(gen);
+        heap.push(key, prio[key]);
+    }
+    REQUIRE(heap.size() == n);
+
+    // equal priorities are popped in key order
+    auto prev_prio = -1;
+    std::size_t prev_key = 0;
+    while (!heap.empty()) {
+        auto key = heap.top();
+        REQUIRE(heap.top_priority() == prio[key]);
+        REQUIRE((prio[key] > prev_prio || (prio[key] == prev_prio && key > prev_key)));
+        prev_prio = prio[key];
+        prev_key = key;
+        heap.pop();
+        REQUIRE(!heap.contains(key));
+    }
+}
+
+TEST_CASE("indexed_heap reset and bounds", "[indexed_heap]") {
+    cbag::util::indexed_heap<int> heap(4);
+    heap.push(2, 5);
+    heap.push(3, 1);
+    REQUIRE(heap.contains(2));
+    REQUIRE(heap.top() == 3);
+    heap.push(2, 0);
+    REQUIRE(heap.top() == 2);
+    REQUIRE(heap.size() == 2);
+    REQUIRE_THROWS_AS(heap.push(4, 0), std::out_of_range);
+
+    heap.reset(8);
+    REQUIRE(heap.empty());
+    REQUIRE(!heap.contains(2));
+    REQUIRE(heap.capacity() == 8);
+    heap.push(7, 3);
+    REQUIRE(heap.top() == 7);
+}
@@ -0,0 +1,34 @@
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/util/memo_cache.h>
+
+TEST_CASE("memo_cache counts hits and misses", "[memo_cache]") {
+    cbag::util::memo_cache<int, std::string> cache;
+    REQUIRE(!cache.find(1));
+    REQUIRE(cache.insert(1, "a") == "a");
+    REQUIRE(*cache.find(1) == "a");
+    // the first inserted value is kept
+    REQUIRE(cache.insert(1, "b") == "a");
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.get_num_hits() == 1);
+    REQUIRE(cache.get_num_misses() == 1);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.get_num_hits() == 0);
+    REQUIRE(cache.get_num_misses() == 0);
+}
+
+TEST_CASE("memo_cache is cleared when full", "[memo_cache]") {
+    cbag::util::memo_cache<int, int> cache(3);
+    for (int idx = 0; idx < 3; ++idx) {
+        cache.insert(idx, 2 * idx);
+    }
+    REQUIRE(cache.size() == 3);
+    REQUIRE(cache.insert(3, 6) == 6);
+    REQUIRE(cache.size() == 1);
+    REQUIRE(!cache.find(0));
+    REQUIRE(*cache.find(3) == 6);
+}
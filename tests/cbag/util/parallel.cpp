@@ -0,0 +1,54 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <cbag/util/parallel.h>
+
+TEST_CASE("parallel_for runs every task once", "[parallel]") {
+    auto num_workers = GENERATE(values<std::size_t>({0, 1, 2, 7}));
+    auto num_tasks = GENERATE(values<std::size_t>({0, 1, 5, 100}));
+
+    std::vector<std::atomic<int>> cnt(num_tasks);
+    cbag::util::parallel_for(num_tasks, num_workers, [&cnt](std::size_t idx) { ++cnt[idx]; });
+    for (const auto &val : cnt) {
+        REQUIRE(val == 1);
+    }
+}
+
+TEST_CASE("parallel_for rethrows task exceptions", "[parallel]") {
+    auto num_workers = GENERATE(values<std::size_t>({1, 4}));
+
+    REQUIRE_THROWS_AS(cbag::util::parallel_for(10, num_workers,
+                                                [](std::size_t idx) {
+                                                    if (idx == 3)
+                                                        throw std::runtime_error("fail");
+                                                }),
+                      std::runtime_error);
+}
+
+TEST_CASE("parallel_for reuses pool threads", "[parallel]") {
+    auto &pool = cbag::util::thread_pool::get_instance();
+    std::atomic<int> cnt{0};
+    cbag::util::parallel_for(8, 4, [&cnt](std::size_t idx) { ++cnt; });
+    auto num_threads = pool.size();
+    REQUIRE(num_threads >= 3);
+    for (int idx = 0; idx < 10; ++idx) {
+        cbag::util::parallel_for(8, 4, [&cnt](std::size_t idx) { ++cnt; });
+    }
+    REQUIRE(cnt == 88);
+    REQUIRE(pool.size() == num_threads);
+}
+
+TEST_CASE("nested parallel_for runs inline", "[parallel]") {
+    std::vector<std::atomic<int>> cnt(16);
+    cbag::util::parallel_for(4, 4, [&cnt](std::size_t outer) {
+        cbag::util::parallel_for(4, 4, [&cnt, outer](std::size_t inner) {
+            ++cnt[outer * 4 + inner];
+        });
+    });
+    for (const auto &val : cnt) {
+        REQUIRE(val == 1);
+    }
+}